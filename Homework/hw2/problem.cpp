@@ -4,19 +4,134 @@
 // (2) CFG: biểu diễn node/edge + xuất DOT
 // (3) Memory allocation/free: stack (automatic) + heap (dynamic)
 // (4) Pointer: dùng/free pointer + minh hoạ use-after-free (được chặn bằng wrapper)
+// (5) Abstract Interpretation: interval domain, widening ở loop head + narrowing
+// (6) SSA (dominator tree + dominance frontier + phi) và def-use chain thưa
+// (7) Interprocedural RD: call graph + SCC bottom-up + function summary (song song)
 #include <iostream>
 #include <vector>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <map>
 #include <set>
 #include <algorithm> // sort
 #include <sstream>   // ostringstream, istringstream
 #include <iomanip>   // setw, left
 #include <stdexcept> // runtime_error
 #include <utility>   // pair, move
+#include <memory>    // unique_ptr
 #include <cctype>    // isspace
+#include <climits>   // LLONG_MIN, LLONG_MAX, INT_MAX
+#include <chrono>    // steady_clock (bench, --stats)
+#include <cstdint>   // uint64_t
+#include <functional> // function
+#include <iterator>  // inserter
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstdlib>   // malloc, free
+#include <new>       // bad_alloc
+#if defined(__APPLE__)
+#include <malloc/malloc.h> // malloc_size
+#else
+#include <malloc.h>  // malloc_usable_size / _msize
+#endif
 using namespace std;
 
+// -------------------------
+// Perf counters (--stats)
+// -------------------------
+// Counters are plain integers bumped inline, so they stay on in every run;
+// StatsReport only formats them at the end.
+struct ScopedTimer {
+    double& acc_ms;
+    chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+    explicit ScopedTimer(double& acc) : acc_ms(acc) {}
+    ~ScopedTimer() { acc_ms += chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count(); }
+};
+
+static void update_hwm(uint64_t& mark, uint64_t v) { if (v > mark) mark = v; }
+
+// Live heap bytes allocated on this thread while a HeapScope is open. The
+// benchmarks measure a structure's footprint as the difference around building
+// it, so every container it owns is counted the same way. Outside a scope
+// operator new/delete are plain malloc/free plus one thread-local flag test.
+static thread_local bool t_heap_counting = false;
+static thread_local long long t_heap_live = 0;
+static long long heap_live() { return t_heap_live; }
+
+struct HeapScope {
+    bool prev = t_heap_counting;
+    HeapScope() { t_heap_counting = true; }
+    ~HeapScope() { t_heap_counting = prev; }
+};
+
+static size_t heap_block_size(void* p) {
+#if defined(__APPLE__)
+    return malloc_size(p);
+#elif defined(_WIN32)
+    return _msize(p);
+#else
+    return malloc_usable_size(p);
+#endif
+}
+
+void* operator new(size_t n) {
+    void* p = malloc(n ? n : 1);
+    if (!p) throw bad_alloc();
+    if (t_heap_counting) t_heap_live += (long long)heap_block_size(p);
+    return p;
+}
+void operator delete(void* p) noexcept {
+    if (p && t_heap_counting) t_heap_live -= (long long)heap_block_size(p);
+    free(p);
+}
+void* operator new[](size_t n) { return operator new(n); }
+void operator delete[](void* p) noexcept { operator delete(p); }
+void operator delete(void* p, size_t) noexcept { operator delete(p); }
+void operator delete[](void* p, size_t) noexcept { operator delete(p); }
+
+struct StatsReport {
+    struct Entry { string section, name; double value; };
+    vector<Entry> entries;
+    bool enabled = false; // set by main only when --stats is given
+
+    void add(const string& section, const string& name, double value) {
+        if (enabled) entries.push_back({section, name, value});
+    }
+
+    // counters print as exact integers, timers keep their fraction
+    static void print_value(ostream& out, double v) {
+        if (v == (double)(long long)v) out << (long long)v;
+        else out << v;
+    }
+
+    void print(ostream& out, bool json) const {
+        if (!json) {
+            out << "=== STATS ===\n";
+            for (auto& e : entries) {
+                out << left << setw(28) << (e.section + "." + e.name) << " ";
+                print_value(out, e.value);
+                out << "\n";
+            }
+            return;
+        }
+        out << "{";
+        for (size_t i = 0; i < entries.size(); ++i) {
+            bool open = (i == 0 || entries[i - 1].section != entries[i].section);
+            bool close = (i + 1 == entries.size() || entries[i + 1].section != entries[i].section);
+            if (open) out << (i ? ", " : "") << "\"" << entries[i].section << "\": {";
+            else out << ", ";
+            out << "\"" << entries[i].name << "\": ";
+            print_value(out, entries[i].value);
+            if (close) out << "}";
+        }
+        out << "}\n";
+    }
+};
+
 // -------------------------
 // Part (2): CFG
 // -------------------------
@@ -82,20 +197,21 @@ static string cfg_to_dot(const CFG& cfg) {
 // Part (1): Dataflow Analysis (Reaching Definitions)
 using Def = pair<string,int>; // (var, node_id)
 
+static void trim_inplace(string& t) {
+    auto issp = [](unsigned char c){ return isspace(c); };
+    while(!t.empty() && issp(t.front())) t.erase(t.begin());
+    while(!t.empty() && issp(t.back()))  t.pop_back();
+}
+
 static set<string> defs_in_stmt(const string& stmt) {
     string s = stmt;
-    auto trim = [](string& t){
-        auto issp = [](unsigned char c){ return isspace(c); };
-        while(!t.empty() && issp(t.front())) t.erase(t.begin());
-        while(!t.empty() && issp(t.back()))  t.pop_back();
-    };
-    trim(s);
+    trim_inplace(s);
 
     if (s.rfind("while", 0) == 0 || s.rfind("if", 0) == 0) return {};
     auto pos = s.find('=');
     if (pos == string::npos) return {};
     string lhs = s.substr(0, pos);
-    trim(lhs);
+    trim_inplace(lhs);
     if (lhs.empty()) return {};
     string var;
     {
@@ -106,11 +222,80 @@ static set<string> defs_in_stmt(const string& stmt) {
     return {var};
 }
 
+struct RDStats {
+    uint64_t sweeps = 0;          // passes over all nodes until nothing changed
+    uint64_t transfer_evals = 0;  // OUT = GEN ∪ (IN − KILL) evaluations
+    uint64_t updates = 0;         // evaluations that changed IN/OUT
+    uint64_t max_set_size = 0;    // high-water mark of |IN| / |OUT|
+    uint64_t set_entries = 0;     // Σ |IN| + |OUT| at the fixpoint
+    double ms = 0;
+};
+
 struct RDResult {
     unordered_map<int, set<Def>> IN, OUT;
+    RDStats stats;
 };
 
+static void add_rd_stats(StatsReport& rep, const RDStats& st) {
+    rep.add("rd", "sweeps", (double)st.sweeps);
+    rep.add("rd", "transfer_evals", (double)st.transfer_evals);
+    rep.add("rd", "updates", (double)st.updates);
+    rep.add("rd", "max_set_size", (double)st.max_set_size);
+    rep.add("rd", "set_entries", (double)st.set_entries);
+    rep.add("rd", "time_ms", st.ms);
+}
+
+// Iterate IN = ∪ OUT(pred), OUT = GEN ∪ (IN − KILL) to the fixpoint. GEN/KILL
+// come from the caller, so call nodes can plug in a callee summary (Part 7).
+static void rd_fixpoint(const CFG& cfg, unordered_map<int, set<Def>>& GEN,
+                        unordered_map<int, set<Def>>& KILL, RDResult& res) {
+    unordered_map<int, vector<int>> pred;
+    for (auto& kv : cfg.nodes) pred[kv.first] = {};
+    for (auto& kv : cfg.nodes) {
+        int from = kv.first;
+        for (int to : kv.second.succ) pred[to].push_back(from);
+    }
+
+    for (auto& kv : cfg.nodes) {
+        res.IN[kv.first] = {};
+        res.OUT[kv.first] = {};
+    }
+
+    vector<int> ids;
+    ids.reserve(cfg.nodes.size());
+    for (auto& kv : cfg.nodes) ids.push_back(kv.first);
+    sort(ids.begin(), ids.end());
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        ++res.stats.sweeps;
+        for (int nid : ids) {
+            set<Def> newIN, newOUT;
+
+            for (int p : pred[nid]) {
+                newIN.insert(res.OUT[p].begin(), res.OUT[p].end());
+            }
+
+            newOUT = GEN[nid];
+            for (auto& d : newIN) if (!KILL[nid].count(d)) newOUT.insert(d);
+            ++res.stats.transfer_evals;
+            update_hwm(res.stats.max_set_size, max(newIN.size(), newOUT.size()));
+
+            if (newIN != res.IN[nid] || newOUT != res.OUT[nid]) {
+                res.IN[nid] = move(newIN);
+                res.OUT[nid] = move(newOUT);
+                changed = true;
+                ++res.stats.updates;
+            }
+        }
+    }
+    for (int nid : ids) res.stats.set_entries += res.IN[nid].size() + res.OUT[nid].size();
+}
+
 static RDResult reaching_definitions(const CFG& cfg) {
+    RDResult res;
+    auto t0 = chrono::steady_clock::now();
     set<Def> U;
     for (auto& kv : cfg.nodes) {
         int nid = kv.first;
@@ -132,45 +317,1208 @@ static RDResult reaching_definitions(const CFG& cfg) {
         KILL[nid] = move(kill);
     }
 
+    rd_fixpoint(cfg, GEN, KILL, res);
+    res.stats.ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+    return res;
+}
+
+// -------------------------
+// Part (5): Abstract Interpretation (Interval domain)
+// -------------------------
+// identifiers, integer literals and the operators used in CFG statements
+static vector<string> tokenize(const string& s) {
+    vector<string> toks;
+    size_t i = 0;
+    while (i < s.size()) {
+        unsigned char c = s[i];
+        if (isspace(c)) { ++i; continue; }
+        size_t j = i;
+        if (isalpha(c) || c == '_') {
+            while (j < s.size() && (isalnum((unsigned char)s[j]) || s[j] == '_')) ++j;
+        } else if (isdigit(c)) {
+            while (j < s.size() && isdigit((unsigned char)s[j])) ++j;
+        } else if ((c == '<' || c == '>' || c == '=' || c == '!') && i + 1 < s.size() && s[i+1] == '=') {
+            j = i + 2;
+        } else {
+            j = i + 1;
+        }
+        toks.push_back(s.substr(i, j - i));
+        i = j;
+    }
+    return toks;
+}
+
+static bool is_ident(const string& t) {
+    return !t.empty() && (isalpha((unsigned char)t[0]) || t[0] == '_');
+}
+
+static const long long NEG_INF = LLONG_MIN;
+static const long long POS_INF = LLONG_MAX;
+
+struct Interval {
+    long long lo = NEG_INF, hi = POS_INF; // default = top
+    bool empty() const { return lo > hi; }
+    bool operator==(const Interval& o) const { return lo == o.lo && hi == o.hi; }
+    bool operator!=(const Interval& o) const { return !(*this == o); }
+};
+
+static long long clamp_bound(__int128 r) {
+    if (r <= (__int128)NEG_INF) return NEG_INF;
+    if (r >= (__int128)POS_INF) return POS_INF;
+    return (long long)r;
+}
+
+static long long bound_neg(long long a) {
+    if (a == NEG_INF) return POS_INF;
+    if (a == POS_INF) return NEG_INF;
+    return -a;
+}
+
+static long long bound_add(long long a, long long b) {
+    if (a == NEG_INF || b == NEG_INF) return NEG_INF;
+    if (a == POS_INF || b == POS_INF) return POS_INF;
+    return clamp_bound((__int128)a + b);
+}
+
+static long long bound_mul(long long a, long long b) {
+    if (a == 0 || b == 0) return 0;
+    bool inf = (a == NEG_INF || a == POS_INF || b == NEG_INF || b == POS_INF);
+    if (inf) return ((a < 0) != (b < 0)) ? NEG_INF : POS_INF;
+    return clamp_bound((__int128)a * b);
+}
+
+static Interval iv_add(Interval a, Interval b) { return {bound_add(a.lo, b.lo), bound_add(a.hi, b.hi)}; }
+static Interval iv_sub(Interval a, Interval b) { return {bound_add(a.lo, bound_neg(b.hi)), bound_add(a.hi, bound_neg(b.lo))}; }
+static Interval iv_mul(Interval a, Interval b) {
+    long long c[4] = {bound_mul(a.lo, b.lo), bound_mul(a.lo, b.hi), bound_mul(a.hi, b.lo), bound_mul(a.hi, b.hi)};
+    return {*min_element(c, c + 4), *max_element(c, c + 4)};
+}
+
+static string interval_to_string(const Interval& v) {
+    if (v.empty()) return "_|_";
+    string lo = (v.lo == NEG_INF ? "-inf" : to_string(v.lo));
+    string hi = (v.hi == POS_INF ? "+inf" : to_string(v.hi));
+    return "[" + lo + "," + hi + "]";
+}
+
+// Abstract state: var -> interval; a var missing from env is top.
+struct AbsState {
+    bool reachable = false;
+    map<string, Interval> env;
+};
+
+static Interval lookup(const AbsState& s, const string& v) {
+    auto it = s.env.find(v);
+    return it == s.env.end() ? Interval{} : it->second;
+}
+
+static AbsState abs_join(const AbsState& a, const AbsState& b) {
+    if (!a.reachable) return b;
+    if (!b.reachable) return a;
+    AbsState r;
+    r.reachable = true;
+    for (auto& [v, x] : a.env) {
+        auto it = b.env.find(v);
+        if (it == b.env.end()) continue;
+        r.env[v] = Interval{min(x.lo, it->second.lo), max(x.hi, it->second.hi)};
+    }
+    return r;
+}
+
+// old ∇ new: any bound that moved jumps straight to infinity
+static AbsState abs_widen(const AbsState& a, const AbsState& b) {
+    if (!a.reachable) return b;
+    if (!b.reachable) return a;
+    AbsState r;
+    r.reachable = true;
+    for (auto& [v, x] : a.env) {
+        auto it = b.env.find(v);
+        if (it == b.env.end()) continue;
+        const Interval& y = it->second;
+        r.env[v] = Interval{y.lo < x.lo ? NEG_INF : x.lo, y.hi > x.hi ? POS_INF : x.hi};
+    }
+    return r;
+}
+
+// old Δ new: only infinite bounds are refined, so the descending phase terminates
+static AbsState abs_narrow(const AbsState& a, const AbsState& b) {
+    if (!a.reachable || !b.reachable) return b;
+    AbsState r = a;
+    for (auto& [v, y] : b.env) {
+        Interval x = lookup(a, v);
+        r.env[v] = Interval{x.lo == NEG_INF ? y.lo : x.lo, x.hi == POS_INF ? y.hi : x.hi};
+    }
+    return r;
+}
+
+static bool abs_leq(const AbsState& a, const AbsState& b) {
+    if (!a.reachable) return true;
+    if (!b.reachable) return false;
+    for (auto& [v, y] : b.env) {
+        Interval x = lookup(a, v);
+        if (x.lo < y.lo || x.hi > y.hi) return false;
+    }
+    return true;
+}
+
+// expr := term (('+'|'-') term)* ; term := atom ('*' atom)* ; atom := num | var | '(' expr ')'
+struct IntervalEval {
+    const vector<string>& t;
+    const AbsState& s;
+    size_t pos = 0;
+    bool ok = true;
+
+    Interval atom() {
+        if (pos >= t.size()) { ok = false; return {}; }
+        const string& tok = t[pos++];
+        if (tok == "(") {
+            Interval v = expr();
+            if (pos < t.size() && t[pos] == ")") ++pos; else ok = false;
+            return v;
+        }
+        if (tok == "-") return iv_sub({0, 0}, atom());
+        if (isdigit((unsigned char)tok[0])) {
+            long long c = stoll(tok);
+            return {c, c};
+        }
+        if (is_ident(tok)) {
+            if (pos < t.size() && t[pos] == "(") { ok = false; return {}; } // call: unknown
+            return lookup(s, tok);
+        }
+        ok = false;
+        return {};
+    }
+    Interval term() {
+        Interval v = atom();
+        while (ok && pos < t.size() && t[pos] == "*") { ++pos; v = iv_mul(v, atom()); }
+        return v;
+    }
+    Interval expr() {
+        Interval v = term();
+        while (ok && pos < t.size() && (t[pos] == "+" || t[pos] == "-")) {
+            bool add = (t[pos++] == "+");
+            Interval r = term();
+            v = add ? iv_add(v, r) : iv_sub(v, r);
+        }
+        return v;
+    }
+};
+
+static Interval eval_interval(const vector<string>& toks, const AbsState& s) {
+    IntervalEval ev{toks, s};
+    Interval v = ev.expr();
+    if (!ev.ok || ev.pos != toks.size()) return {};
+    return v;
+}
+
+// "while (c)" / "if (c)" -> tokens of c, empty if stmt is not a branch
+static vector<string> branch_condition(const string& stmt) {
+    string s = stmt;
+    trim_inplace(s);
+    if (s.rfind("while", 0) != 0 && s.rfind("if", 0) != 0) return {};
+    auto l = s.find('('), r = s.rfind(')');
+    if (l == string::npos || r == string::npos || r <= l) return {};
+    return tokenize(s.substr(l + 1, r - l - 1));
+}
+
+static string negate_cmp(const string& op) {
+    if (op == "<")  return ">=";
+    if (op == "<=") return ">";
+    if (op == ">")  return "<=";
+    if (op == ">=") return "<";
+    if (op == "==") return "!=";
+    if (op == "!=") return "==";
+    return "";
+}
+
+static string flip_cmp(const string& op) {
+    if (op == "<")  return ">";
+    if (op == "<=") return ">=";
+    if (op == ">")  return "<";
+    if (op == ">=") return "<=";
+    return op;
+}
+
+// x := x ∩ { v | v op r }
+static Interval refine_cmp(Interval x, const string& op, const Interval& r) {
+    if (op == "<")  x.hi = min(x.hi, bound_add(r.hi, -1));
+    if (op == "<=") x.hi = min(x.hi, r.hi);
+    if (op == ">")  x.lo = max(x.lo, bound_add(r.lo, 1));
+    if (op == ">=") x.lo = max(x.lo, r.lo);
+    if (op == "==") { x.lo = max(x.lo, r.lo); x.hi = min(x.hi, r.hi); }
+    if (op == "!=" && r.lo == r.hi) {
+        if (x.lo == r.lo) x.lo = bound_add(x.lo, 1);
+        else if (x.hi == r.hi) x.hi = bound_add(x.hi, -1);
+    }
+    return x;
+}
+
+static AbsState assume(const AbsState& s, const vector<string>& cond, bool taken) {
+    if (!s.reachable) return s;
+    size_t k = 0;
+    while (k < cond.size() && negate_cmp(cond[k]).empty()) ++k;
+    if (k == 0 || k + 1 >= cond.size()) return s; // not "lhs op rhs": no refinement
+    string op = taken ? cond[k] : negate_cmp(cond[k]);
+    vector<string> lhs(cond.begin(), cond.begin() + k), rhs(cond.begin() + k + 1, cond.end());
+    Interval lv = eval_interval(lhs, s), rv = eval_interval(rhs, s);
+
+    AbsState r = s;
+    if (lhs.size() == 1 && is_ident(lhs[0])) r.env[lhs[0]] = refine_cmp(lv, op, rv);
+    if (rhs.size() == 1 && is_ident(rhs[0])) r.env[rhs[0]] = refine_cmp(rv, flip_cmp(op), lv);
+    for (auto& [v, x] : r.env) if (x.empty()) return AbsState{};
+    return r;
+}
+
+static AbsState interval_transfer(const Node& n, const AbsState& in) {
+    if (!in.reachable) return in;
+    auto defs = defs_in_stmt(n.stmt);
+    if (defs.empty()) return in;
+    AbsState out = in;
+    string rhs = n.stmt.substr(n.stmt.find('=') + 1);
+    Interval v = eval_interval(tokenize(rhs), in);
+    if (v == Interval{}) out.env.erase(*defs.begin());
+    else out.env[*defs.begin()] = v;
+    return out;
+}
+
+// Weak topological order (Bourdoncle): a component is (head, body); a plain
+// vertex has comp == false and no kids.
+struct WTOElem {
+    int v;
+    bool comp;
+    vector<WTOElem> kids;
+};
+
+// Bourdoncle's visit/component with an explicit stack: generated CFGs are deep.
+// A frame starts as visit(v); if v turns out to head a loop it becomes
+// component(v), whose body partition is heap-owned so child frames can point
+// into it while the frame vector grows.
+struct WTOBuilder {
+    const CFG& cfg;
+    unordered_map<int, int> dfn;
+    vector<int> stack;
+    int num = 0;
+
+    struct Frame {
+        int v = -1;
+        vector<WTOElem>* part = nullptr; // partition this element is appended to
+        size_t k = 0;                   // next successor
+        int head = 0;
+        bool loop = false, comp = false, waiting = false;
+        unique_ptr<vector<WTOElem>> body;
+    };
+
+    void visit(int root, vector<WTOElem>& partition) {
+        vector<Frame> frames;
+        auto enter = [&](int v, vector<WTOElem>* part) {
+            stack.push_back(v);
+            dfn[v] = ++num;
+            frames.emplace_back();
+            frames.back().v = v;
+            frames.back().part = part;
+            frames.back().head = dfn[v];
+        };
+        enter(root, &partition);
+        int ret = 0; // head returned by the last finished visit
+        while (!frames.empty()) {
+            Frame& f = frames.back();
+            const auto& succ = cfg.nodes.at(f.v).succ;
+            if (f.waiting) {
+                f.waiting = false;
+                if (!f.comp && ret <= f.head) { f.head = ret; f.loop = true; }
+            }
+            if (f.k < succ.size()) {
+                int w = succ[f.k++];
+                if (f.comp) {
+                    if (dfn[w] == 0) { f.waiting = true; enter(w, f.body.get()); }
+                } else if (dfn[w] == 0) {
+                    f.waiting = true;
+                    enter(w, f.part);
+                } else if (dfn[w] <= f.head) {
+                    f.head = dfn[w];
+                    f.loop = true;
+                }
+                continue;
+            }
+            if (f.comp) {
+                reverse(f.body->begin(), f.body->end());
+                f.part->push_back(WTOElem{f.v, true, move(*f.body)});
+            } else if (f.head == dfn[f.v]) {
+                dfn[f.v] = INT_MAX;
+                int e = stack.back(); stack.pop_back();
+                if (f.loop) {
+                    while (e != f.v) { dfn[e] = 0; e = stack.back(); stack.pop_back(); }
+                    f.comp = true; // now run component(v)
+                    f.k = 0;
+                    f.body = make_unique<vector<WTOElem>>();
+                    continue;
+                }
+                f.part->push_back(WTOElem{f.v, false, {}});
+            }
+            ret = f.head;
+            frames.pop_back();
+        }
+    }
+};
+
+static vector<WTOElem> weak_topological_order(const CFG& cfg) {
+    WTOBuilder b{cfg, {}, {}, 0};
+    vector<WTOElem> wto;
+    b.visit(cfg.entry, wto);
+    reverse(wto.begin(), wto.end());
+    return wto;
+}
+
+static string wto_to_string(const vector<WTOElem>& wto) {
+    ostringstream out;
+    for (size_t i = 0; i < wto.size(); ++i) {
+        if (i) out << " ";
+        if (!wto[i].comp) { out << wto[i].v; continue; }
+        out << "(" << wto[i].v;
+        if (!wto[i].kids.empty()) out << " " << wto_to_string(wto[i].kids);
+        out << ")";
+    }
+    return out.str();
+}
+
+// u -> v where v is still on the DFS stack from entry
+static vector<pair<int,int>> back_edges(const CFG& cfg) {
+    vector<pair<int,int>> res;
+    unordered_map<int, int> color; // 0 white, 1 on stack, 2 done
+    vector<pair<int, size_t>> st{{cfg.entry, 0}};
+    color[cfg.entry] = 1;
+    while (!st.empty()) {
+        auto& [u, k] = st.back();
+        const auto& succ = cfg.nodes.at(u).succ;
+        if (k == succ.size()) { color[u] = 2; st.pop_back(); continue; }
+        int w = succ[k++];
+        if (color[w] == 1) res.push_back({u, w});
+        else if (color[w] == 0) { color[w] = 1; st.push_back({w, 0}); }
+    }
+    sort(res.begin(), res.end());
+    return res;
+}
+
+struct IntervalResult {
+    unordered_map<int, AbsState> IN, OUT;
+    vector<pair<int,int>> back_edges;
+    set<int> widen_points;
+    vector<WTOElem> wto;
+    int node_evals = 0;        // transfer evaluations in the ascending (widening) phase
+    int narrowing_passes = 0;  // descending sweeps (per loop) until nothing shrank
+};
+
+struct IntervalSolver {
+    const CFG& cfg;
+    IntervalResult& res;
+    int max_narrowing;
     unordered_map<int, vector<int>> pred;
-    for (auto& kv : cfg.nodes) pred[kv.first] = {};
-    for (auto& kv : cfg.nodes) {
-        int from = kv.first;
-        for (int to : kv.second.succ) pred[to].push_back(from);
+
+    // state flowing along p -> n, refined by p's branch condition
+    AbsState edge_state(int p, int n) {
+        const Node& pn = cfg.nodes.at(p);
+        const AbsState& out = res.OUT[p];
+        if (pn.succ.size() != 2) return out;
+        auto cond = branch_condition(pn.stmt);
+        if (cond.empty()) return out;
+        if (pn.succ[0] == n && pn.succ[1] == n) return out;
+        return assume(out, cond, pn.succ[0] == n); // succ[0] = true branch
     }
 
-    RDResult res;
+    AbsState join_preds(int n) {
+        AbsState in;
+        if (n == cfg.entry) in.reachable = true;
+        for (int p : pred[n]) in = abs_join(in, edge_state(p, n));
+        return in;
+    }
+
+    void set_in(int n, AbsState in) {
+        res.OUT[n] = interval_transfer(cfg.nodes.at(n), in);
+        res.IN[n] = move(in);
+        ++res.node_evals;
+    }
+
+    void solve(const WTOElem& e) {
+        if (!e.comp) { set_in(e.v, join_preds(e.v)); return; }
+        int h = e.v;
+        bool widen = res.widen_points.count(h) > 0;
+        set_in(h, join_preds(h));
+        while (true) {
+            for (auto& k : e.kids) solve(k);
+            AbsState in = join_preds(h);
+            if (abs_leq(in, res.IN[h])) break;
+            set_in(h, widen ? abs_widen(res.IN[h], in) : abs_join(res.IN[h], in));
+        }
+        // Narrow this loop before its exit edge is followed; otherwise the
+        // widened bounds leak into later loops and become a fixpoint there.
+        for (int pass = 0; pass < max_narrowing; ++pass) {
+            ++res.narrowing_passes;
+            if (!narrow(e)) break;
+        }
+    }
+
+    // one descending sweep over e (and nested components); true if anything shrank
+    bool narrow(const WTOElem& e) {
+        AbsState in = join_preds(e.v);
+        if (e.comp && res.widen_points.count(e.v)) in = abs_narrow(res.IN[e.v], in);
+        bool changed = !abs_leq(res.IN[e.v], in);
+        res.OUT[e.v] = interval_transfer(cfg.nodes.at(e.v), in);
+        res.IN[e.v] = move(in);
+        for (auto& k : e.kids) if (narrow(k)) changed = true;
+        return changed;
+    }
+};
+
+static void collect_heads(const vector<WTOElem>& wto, set<int>& heads) {
+    for (auto& e : wto) if (e.comp) { heads.insert(e.v); collect_heads(e.kids, heads); }
+}
+
+static IntervalResult interval_analysis(const CFG& cfg, int max_narrowing = 8) {
+    IntervalResult res;
+    res.back_edges = back_edges(cfg);
+    for (auto& be : res.back_edges) res.widen_points.insert(be.second);
+    res.wto = weak_topological_order(cfg);
+    collect_heads(res.wto, res.widen_points); // irreducible loops still need a widening point
+
+    IntervalSolver s{cfg, res, max_narrowing, {}};
+    for (auto& kv : cfg.nodes) s.pred[kv.first];
+    for (auto& kv : cfg.nodes) for (int to : kv.second.succ) s.pred[to].push_back(kv.first);
+
+    for (auto& e : res.wto) s.solve(e);
+    return res;
+}
+
+static string abs_state_to_string(const AbsState& s) {
+    if (!s.reachable) return "unreachable";
+    ostringstream out;
+    out << "{";
+    bool first = true;
+    for (auto& [v, x] : s.env) {
+        if (!first) out << ", ";
+        first = false;
+        out << v << ":" << interval_to_string(x);
+    }
+    out << "}";
+    return out.str();
+}
+
+// -------------------------
+// Part (6): SSA + sparse def-use chains
+// -------------------------
+// variables read by a statement (identifiers followed by '(' are calls, not reads)
+static set<string> uses_in_stmt(const string& stmt) {
+    string s = stmt;
+    trim_inplace(s);
+    if (s == "Start" || s == "End") return {};
+    if (!defs_in_stmt(s).empty()) s = s.substr(s.find('=') + 1);
+    auto toks = tokenize(s);
+    set<string> res;
+    for (size_t k = 0; k < toks.size(); ++k) {
+        if (!is_ident(toks[k])) continue;
+        if (toks[k] == "while" || toks[k] == "if") continue;
+        if (k + 1 < toks.size() && toks[k + 1] == "(") continue;
+        res.insert(toks[k]);
+    }
+    return res;
+}
+
+struct SSAValue {
+    string var;
+    int version;       // 0 = value on entry (no definition reaches)
+    int node;          // defining node, -1 for version 0
+    bool phi;
+    vector<int> args;  // phi operands, in the order of pred[node]
+    vector<int> uses;  // def-use chain: nodes that read this value (phis included)
+};
+
+struct SSAForm {
+    vector<int> rpo;
+    unordered_map<int, int> idom;
+    unordered_map<int, vector<int>> dom_children;
+    unordered_map<int, set<int>> DF;
+    unordered_map<int, vector<int>> pred;
+    vector<SSAValue> values;
+    unordered_map<int, vector<pair<string,int>>> phis;      // node -> (var, phi value)
+    unordered_map<int, int> def_value;                      // node -> value its stmt defines
+    unordered_map<int, vector<pair<string,int>>> use_value; // node -> (var, value read)
+
+    string name(int v) const { return values[v].var + "_" + to_string(values[v].version); }
+
+    // the SSA value a use of `var` at `node` reads; -1 if node does not read var
+    int value_of_use(int node, const string& var) const {
+        auto it = use_value.find(node);
+        if (it == use_value.end()) return -1;
+        for (auto& [v, val] : it->second) if (v == var) return val;
+        return -1;
+    }
+};
+
+// Cooper/Harvey/Kennedy: iterate idom over reverse postorder until stable.
+static void compute_dominators(const CFG& cfg, SSAForm& ssa) {
+    unordered_map<int, int> po_num;
+    vector<int> po;
+    vector<pair<int, size_t>> st{{cfg.entry, 0}};
+    po_num[cfg.entry] = -1;
+    while (!st.empty()) {
+        auto& [u, k] = st.back();
+        const auto& succ = cfg.nodes.at(u).succ;
+        if (k == succ.size()) {
+            po_num[u] = (int)po.size();
+            po.push_back(u);
+            st.pop_back();
+            continue;
+        }
+        int w = succ[k++];
+        if (!po_num.count(w)) { po_num[w] = -1; st.push_back({w, 0}); }
+    }
+    ssa.rpo.assign(po.rbegin(), po.rend());
+
+    auto intersect = [&](int a, int b) {
+        while (a != b) {
+            while (po_num[a] < po_num[b]) a = ssa.idom[a];
+            while (po_num[b] < po_num[a]) b = ssa.idom[b];
+        }
+        return a;
+    };
+
+    ssa.idom[cfg.entry] = cfg.entry;
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int b : ssa.rpo) {
+            if (b == cfg.entry) continue;
+            int new_idom = -1;
+            for (int p : ssa.pred[b]) {
+                if (!ssa.idom.count(p)) continue; // not processed yet / unreachable
+                new_idom = (new_idom == -1) ? p : intersect(p, new_idom);
+            }
+            auto it = ssa.idom.find(b);
+            if (it == ssa.idom.end() || it->second != new_idom) {
+                ssa.idom[b] = new_idom;
+                changed = true;
+            }
+        }
+    }
+    for (int b : ssa.rpo) if (b != cfg.entry) ssa.dom_children[ssa.idom[b]].push_back(b);
+
+    for (int b : ssa.rpo) {
+        const auto& ps = ssa.pred[b];
+        if (ps.size() < 2) continue;
+        for (int p : ps) {
+            if (!ssa.idom.count(p)) continue;
+            for (int r = p; r != ssa.idom[b]; r = ssa.idom[r]) ssa.DF[r].insert(b);
+        }
+    }
+}
+
+static SSAForm build_ssa(const CFG& cfg) {
+    SSAForm ssa;
+    for (auto& kv : cfg.nodes) ssa.pred[kv.first];
+    {
+        vector<int> ids;
+        for (auto& kv : cfg.nodes) ids.push_back(kv.first);
+        sort(ids.begin(), ids.end()); // deterministic pred order
+        for (int id : ids) for (int s : cfg.nodes.at(id).succ) ssa.pred[s].push_back(id);
+    }
+    compute_dominators(cfg, ssa);
+
+    // phi placement on the iterated dominance frontier of each variable's defs
+    map<string, vector<int>> defsites;
+    set<string> vars;
+    for (int b : ssa.rpo) {
+        for (auto& v : defs_in_stmt(cfg.nodes.at(b).stmt)) { defsites[v].push_back(b); vars.insert(v); }
+        for (auto& v : uses_in_stmt(cfg.nodes.at(b).stmt)) vars.insert(v);
+    }
+
+    unordered_map<string, int> next_version;
+    auto new_value = [&](const string& var, int node) {
+        int version = next_version[var]++;
+        ssa.values.push_back(SSAValue{var, version, node, false, {}, {}});
+        return (int)ssa.values.size() - 1;
+    };
+
+    unordered_map<string, vector<int>> stacks;
+    for (auto& v : vars) stacks[v].push_back(new_value(v, -1)); // v_0
+
+    for (auto& [v, sites] : defsites) {
+        unordered_set<int> has_phi, queued(sites.begin(), sites.end());
+        vector<int> work = sites;
+        while (!work.empty()) {
+            int d = work.back(); work.pop_back();
+            for (int y : ssa.DF[d]) {
+                if (has_phi.count(y)) continue;
+                has_phi.insert(y);
+                // version is assigned when the renamer reaches y
+                ssa.values.push_back(SSAValue{v, -1, y, true, vector<int>(ssa.pred[y].size(), -1), {}});
+                ssa.phis[y].push_back({v, (int)ssa.values.size() - 1});
+                if (!queued.count(y)) { queued.insert(y); work.push_back(y); }
+            }
+        }
+    }
+
+    // rename along the dominator tree (explicit stack: generated CFGs are deep)
+    struct Frame { int b; bool done; vector<string> pushed; };
+    vector<Frame> todo{{cfg.entry, false, {}}};
+    while (!todo.empty()) {
+        if (todo.back().done) {
+            for (auto& v : todo.back().pushed) stacks[v].pop_back();
+            todo.pop_back();
+            continue;
+        }
+        todo.back().done = true;
+        int b = todo.back().b;
+        vector<string> pushed;
+
+        for (auto& [v, val] : ssa.phis[b]) {
+            ssa.values[val].version = next_version[v]++;
+            stacks[v].push_back(val);
+            pushed.push_back(v);
+        }
+        const string& stmt = cfg.nodes.at(b).stmt;
+        for (auto& v : uses_in_stmt(stmt)) {
+            int val = stacks[v].back();
+            ssa.use_value[b].push_back({v, val});
+            ssa.values[val].uses.push_back(b);
+        }
+        for (auto& v : defs_in_stmt(stmt)) {
+            int val = new_value(v, b);
+            ssa.def_value[b] = val;
+            stacks[v].push_back(val);
+            pushed.push_back(v);
+        }
+        for (int s : cfg.nodes.at(b).succ) {
+            const auto& ps = ssa.pred[s];
+            for (size_t j = 0; j < ps.size(); ++j) {
+                if (ps[j] != b) continue;
+                for (auto& [v, val] : ssa.phis[s]) {
+                    int arg = stacks[v].back();
+                    ssa.values[val].args[j] = arg;
+                    ssa.values[arg].uses.push_back(s);
+                }
+            }
+        }
+        todo.back().pushed = move(pushed);
+        auto it = ssa.dom_children.find(b);
+        if (it != ssa.dom_children.end())
+            for (auto c = it->second.rbegin(); c != it->second.rend(); ++c) todo.push_back({*c, false, {}});
+    }
+    return ssa;
+}
+
+// Original definitions behind every SSA value: a real def is itself, v_0 is
+// nothing, a phi is the union of its operands (worklist over the phi graph).
+static vector<set<Def>> ssa_value_defs(const SSAForm& ssa) {
+    vector<set<Def>> res(ssa.values.size());
+    unordered_map<int, vector<int>> phi_users;
+    vector<int> work;
+    for (int v = 0; v < (int)ssa.values.size(); ++v) {
+        const auto& sv = ssa.values[v];
+        if (sv.phi) {
+            for (int a : sv.args) if (a >= 0) phi_users[a].push_back(v);
+            work.push_back(v);
+        } else if (sv.node >= 0) {
+            res[v].insert({sv.var, sv.node});
+        }
+    }
+    while (!work.empty()) {
+        int v = work.back(); work.pop_back();
+        size_t before = res[v].size();
+        for (int a : ssa.values[v].args) if (a >= 0) res[v].insert(res[a].begin(), res[a].end());
+        if (res[v].size() == before) continue;
+        for (int u : phi_users[v]) work.push_back(u);
+    }
+    return res;
+}
+
+// Defs reaching one use, resolved on demand: walk back from the value the use
+// reads through phi operands only, instead of densifying every value.
+static set<Def> ssa_reaching_defs(const SSAForm& ssa, int node, const string& var) {
+    set<Def> res;
+    int start = ssa.value_of_use(node, var);
+    if (start < 0) return res;
+    vector<int> work{start};
+    unordered_set<int> seen{start};
+    while (!work.empty()) {
+        const SSAValue& sv = ssa.values[work.back()];
+        work.pop_back();
+        if (!sv.phi) {
+            if (sv.node >= 0) res.insert({sv.var, sv.node});
+            continue;
+        }
+        for (int a : sv.args) if (a >= 0 && seen.insert(a).second) work.push_back(a);
+    }
+    return res;
+}
+
+// RD OUT sets rebuilt from SSA: the value of each var live-out of n is the
+// nearest def/phi up the dominator tree.
+static unordered_map<int, set<Def>> rd_out_from_ssa(const CFG& cfg, const SSAForm& ssa) {
+    auto vdefs = ssa_value_defs(ssa);
+    unordered_map<int, map<string,int>> cur; // var -> value at node exit
+    unordered_map<int, set<Def>> OUT;
+    for (int b : ssa.rpo) { // idom(b) precedes b in RPO
+        map<string,int> m;
+        if (b != cfg.entry) m = cur[ssa.idom.at(b)];
+        else for (int v = 0; v < (int)ssa.values.size(); ++v)
+            if (ssa.values[v].version == 0) m[ssa.values[v].var] = v;
+        auto ph = ssa.phis.find(b);
+        if (ph != ssa.phis.end()) for (auto& [v, val] : ph->second) m[v] = val;
+        auto d = ssa.def_value.find(b);
+        if (d != ssa.def_value.end()) m[ssa.values[d->second].var] = d->second;
+        set<Def> out;
+        for (auto& [v, val] : m) out.insert(vdefs[val].begin(), vdefs[val].end());
+        OUT[b] = move(out);
+        cur[b] = move(m);
+    }
+    return OUT;
+}
+
+// -------------------------
+// Part (7): Interprocedural RD with cached function summaries
+// -------------------------
+// One CFG per function; node ids are unique across the whole program so a
+// Def (var, node) still names one statement. All variables are globals.
+struct Program {
+    string main_fn;
+    vector<string> funcs;             // declaration order
+    unordered_map<string, CFG> cfgs;
+};
+
+// "call f" -> "f", anything else -> ""
+static string callee_of(const string& stmt) {
+    auto toks = tokenize(stmt);
+    if (toks.size() == 2 && toks[0] == "call" && is_ident(toks[1])) return toks[1];
+    return "";
+}
+
+struct FuncSummary {
+    set<Def> gen;       // defs made in f (or its callees) that reach f's exit
+    set<string> must;   // vars assigned on every entry -> exit path: killed at the call site
+    set<string> mod;    // vars f may assign
+    set<string> ref;    // vars f may read
+    int rounds = 0;     // times f was analysed (> 1 only inside recursive SCCs)
+    bool operator==(const FuncSummary& o) const {
+        return gen == o.gen && must == o.must && mod == o.mod && ref == o.ref;
+    }
+};
+
+struct CallGraph {
+    unordered_map<string, vector<string>> callees;   // sorted, unique
+    vector<vector<string>> sccs;                     // callees before callers
+    unordered_map<string, int> scc_of;
+    vector<int> level;                               // per SCC: 0 = calls only itself/nothing
+};
+
+static CallGraph build_call_graph(const Program& prog) {
+    CallGraph cg;
+    for (auto& f : prog.funcs) {
+        set<string> cs;
+        for (auto& kv : prog.cfgs.at(f).nodes) {
+            string c = callee_of(kv.second.stmt);
+            if (!c.empty() && prog.cfgs.count(c)) cs.insert(c);
+        }
+        cg.callees[f].assign(cs.begin(), cs.end());
+    }
+
+    // Tarjan: SCCs come out in reverse topological order, i.e. callees first.
+    // Explicit stack of (function, next callee): call chains can be very deep.
+    unordered_map<string, int> index, low;
+    unordered_set<string> on_stack;
+    vector<string> st;
+    int counter = 0;
+    auto enter = [&](vector<pair<string, size_t>>& frames, const string& v) {
+        index[v] = low[v] = counter++;
+        st.push_back(v);
+        on_stack.insert(v);
+        frames.push_back({v, 0});
+    };
+    for (auto& root : prog.funcs) {
+        if (index.count(root)) continue;
+        vector<pair<string, size_t>> frames;
+        enter(frames, root);
+        while (!frames.empty()) {
+            string v = frames.back().first;
+            const auto& cs = cg.callees[v];
+            size_t& k = frames.back().second;
+            if (k < cs.size()) {
+                const string& w = cs[k++];
+                if (!index.count(w)) enter(frames, w);
+                else if (on_stack.count(w)) low[v] = min(low[v], index[w]);
+                continue;
+            }
+            frames.pop_back();
+            if (!frames.empty()) {
+                const string& parent = frames.back().first;
+                low[parent] = min(low[parent], low[v]);
+            }
+            if (low[v] != index[v]) continue;
+            vector<string> comp;
+            string w;
+            do {
+                w = st.back(); st.pop_back();
+                on_stack.erase(w);
+                comp.push_back(w);
+            } while (w != v);
+            sort(comp.begin(), comp.end());
+            for (auto& f : comp) cg.scc_of[f] = (int)cg.sccs.size();
+            cg.sccs.push_back(move(comp));
+        }
+    }
+
+    // SCCs on the same level never call each other, so a level can run in parallel
+    cg.level.assign(cg.sccs.size(), 0);
+    for (size_t c = 0; c < cg.sccs.size(); ++c) {
+        for (auto& f : cg.sccs[c])
+            for (auto& g : cg.callees[f]) {
+                int d = cg.scc_of[g];
+                if (d != (int)c) cg.level[c] = max(cg.level[c], cg.level[d] + 1);
+            }
+    }
+    return cg;
+}
+
+// Minimal fixed-size pool: submit() jobs, wait() until every job has finished.
+class ThreadPool {
+    vector<thread> workers;
+    queue<function<void()>> jobs;
+    mutex m;
+    condition_variable cv, idle_cv;
+    size_t pending = 0;
+    bool stop = false;
+
+public:
+    explicit ThreadPool(unsigned n) {
+        for (unsigned k = 0; k < max(1u, n); ++k) {
+            workers.emplace_back([this] {
+                while (true) {
+                    function<void()> job;
+                    {
+                        unique_lock<mutex> lk(m);
+                        cv.wait(lk, [this] { return stop || !jobs.empty(); });
+                        if (stop && jobs.empty()) return;
+                        job = move(jobs.front());
+                        jobs.pop();
+                    }
+                    job();
+                    lock_guard<mutex> lk(m);
+                    if (--pending == 0) idle_cv.notify_all();
+                }
+            });
+        }
+    }
+    ~ThreadPool() {
+        {
+            lock_guard<mutex> lk(m);
+            stop = true;
+        }
+        cv.notify_all();
+        for (auto& w : workers) w.join();
+    }
+    void submit(function<void()> job) {
+        {
+            lock_guard<mutex> lk(m);
+            jobs.push(move(job));
+            ++pending;
+        }
+        cv.notify_one();
+    }
+    void wait() {
+        unique_lock<mutex> lk(m);
+        idle_cv.wait(lk, [this] { return pending == 0; });
+    }
+};
+
+struct InterprocResult {
+    CallGraph cg;
+    unordered_map<string, FuncSummary> summaries;
+    unordered_map<string, RDResult> rd;   // per function, entry IN = {}
+    int levels = 0;
+    uint64_t summary_uses = 0;            // call sites resolved from the summary cache
+    uint64_t analyses = 0;                // intraprocedural solver runs
+    double ms = 0;
+};
+
+// RD over one function, applying callee summaries at "call f" nodes.
+static RDResult analyze_function(const CFG& cfg, const unordered_map<string, FuncSummary>& sums,
+                                 const set<string>& all_vars, FuncSummary& out, uint64_t& summary_uses) {
+    unordered_map<int, set<Def>> GEN;
+    unordered_map<int, set<string>> kill_vars;
+    FuncSummary fs;
     for (auto& kv : cfg.nodes) {
-        res.IN[kv.first] = {};
-        res.OUT[kv.first] = {};
+        int nid = kv.first;
+        const string& stmt = kv.second.stmt;
+        string c = callee_of(stmt);
+        if (!c.empty()) {
+            auto it = sums.find(c);
+            if (it == sums.end()) continue; // external: no effect
+            ++summary_uses;
+            GEN[nid] = it->second.gen;
+            kill_vars[nid] = it->second.must;
+            fs.mod.insert(it->second.mod.begin(), it->second.mod.end());
+            fs.ref.insert(it->second.ref.begin(), it->second.ref.end());
+            continue;
+        }
+        for (auto& v : defs_in_stmt(stmt)) {
+            GEN[nid].insert({v, nid});
+            kill_vars[nid].insert(v);
+            fs.mod.insert(v);
+        }
+        for (auto& v : uses_in_stmt(stmt)) fs.ref.insert(v);
     }
 
+    set<Def> U;
+    for (auto& kv : GEN) U.insert(kv.second.begin(), kv.second.end());
+    unordered_map<int, set<Def>> KILL;
+    for (auto& [nid, vars] : kill_vars)
+        for (auto& d : U)
+            if (vars.count(d.first) && !GEN[nid].count(d)) KILL[nid].insert(d);
+
+    RDResult res;
+    rd_fixpoint(cfg, GEN, KILL, res);
+    fs.gen = res.OUT[cfg.exit];
+
+    // must-assigned vars: forward, intersection over preds, optimistic start
+    unordered_map<int, vector<int>> pred;
+    for (auto& kv : cfg.nodes) for (int s : kv.second.succ) pred[s].push_back(kv.first);
+    unordered_map<int, set<string>> must_out;
+    for (auto& kv : cfg.nodes) must_out[kv.first] = all_vars;
     vector<int> ids;
-    ids.reserve(cfg.nodes.size());
     for (auto& kv : cfg.nodes) ids.push_back(kv.first);
     sort(ids.begin(), ids.end());
-
     bool changed = true;
     while (changed) {
         changed = false;
         for (int nid : ids) {
-            set<Def> newIN, newOUT;
-
-            for (int p : pred[nid]) {
-                newIN.insert(res.OUT[p].begin(), res.OUT[p].end());
+            set<string> in;
+            if (nid != cfg.entry && !pred[nid].empty()) {
+                in = must_out[pred[nid][0]];
+                for (size_t k = 1; k < pred[nid].size(); ++k) {
+                    set<string> tmp;
+                    const auto& o = must_out[pred[nid][k]];
+                    set_intersection(in.begin(), in.end(), o.begin(), o.end(), inserter(tmp, tmp.begin()));
+                    in = move(tmp);
+                }
             }
+            in.insert(kill_vars[nid].begin(), kill_vars[nid].end());
+            if (in != must_out[nid]) { must_out[nid] = move(in); changed = true; }
+        }
+    }
+    fs.must = must_out[cfg.exit];
+    out = move(fs);
+    return res;
+}
 
-            newOUT = GEN[nid];
-            for (auto& d : newIN) if (!KILL[nid].count(d)) newOUT.insert(d);
+// Bottom-up over call-graph SCCs; SCCs of one level go to the pool together.
+// keep_rd = false drops the per-node IN/OUT sets once a summary is built.
+static InterprocResult interprocedural_rd(const Program& prog, unsigned threads, bool keep_rd = true) {
+    InterprocResult r;
+    auto t0 = chrono::steady_clock::now();
+    r.cg = build_call_graph(prog);
 
-            if (newIN != res.IN[nid] || newOUT != res.OUT[nid]) {
-                res.IN[nid] = move(newIN);
-                res.OUT[nid] = move(newOUT);
-                changed = true;
+    set<string> all_vars;
+    for (auto& f : prog.funcs)
+        for (auto& kv : prog.cfgs.at(f).nodes)
+            for (auto& v : defs_in_stmt(kv.second.stmt)) all_vars.insert(v);
+
+    // every slot exists up front: workers only assign into their own SCC's entries
+    for (auto& f : prog.funcs) {
+        if (keep_rd) r.rd[f];
+        FuncSummary& fs = r.summaries[f];
+        fs.must = all_vars; // optimistic start for recursive SCCs
+    }
+
+    map<int, vector<int>> by_level;
+    for (size_t c = 0; c < r.cg.sccs.size(); ++c) by_level[r.cg.level[c]].push_back((int)c);
+    r.levels = (int)by_level.size();
+
+    atomic<uint64_t> summary_uses{0}, analyses{0};
+    auto solve_scc = [&](int c) {
+        const auto& members = r.cg.sccs[c];
+        bool recursive = members.size() > 1;
+        for (auto& g : r.cg.callees.at(members[0])) if (g == members[0]) recursive = true;
+        uint64_t uses = 0, runs = 0;
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (auto& f : members) {
+                FuncSummary fs;
+                FuncSummary& slot = r.summaries.at(f);
+                RDResult res = analyze_function(prog.cfgs.at(f), r.summaries, all_vars, fs, uses);
+                if (keep_rd) r.rd.at(f) = move(res);
+                ++runs;
+                fs.rounds = slot.rounds + 1;
+                if (!(fs == slot)) changed = true;
+                slot = move(fs);
             }
+            if (!recursive) break;
         }
+        summary_uses += uses;
+        analyses += runs;
+    };
+
+    ThreadPool pool(threads);
+    for (auto& [lvl, comps] : by_level) {
+        (void)lvl;
+        for (int c : comps) pool.submit([&solve_scc, c] { solve_scc(c); });
+        pool.wait();
     }
-    return res;
+    r.summary_uses = summary_uses;
+    r.analyses = analyses;
+    r.ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+    return r;
+}
+
+static string str_set_to_string(const set<string>& s) {
+    ostringstream out;
+    out << "{";
+    bool first = true;
+    for (auto& v : s) { out << (first ? "" : ", ") << v; first = false; }
+    out << "}";
+    return out.str();
+}
+
+// main calls inc, reset and a self-recursive countdown; reset calls inc.
+static Program build_example_program() {
+    Program prog;
+    prog.main_fn = "main";
+    auto add_fn = [&](const string& name, int entry, int exit, vector<Node> nodes) {
+        CFG cfg;
+        cfg.entry = entry;
+        cfg.exit = exit;
+        for (auto& n : nodes) cfg.nodes[n.id] = n;
+        prog.funcs.push_back(name);
+        prog.cfgs[name] = move(cfg);
+    };
+    add_fn("main", 0, 7, {
+        {0, "Start", {1}},
+        {1, "x = 0", {2}},
+        {2, "call inc", {3}},
+        {3, "if (x < 5)", {4, 5}},
+        {4, "call reset", {5}},
+        {5, "call countdown", {6}},
+        {6, "print(x)", {7}},
+        {7, "End", {}},
+    });
+    add_fn("inc", 10, 13, {
+        {10, "Start", {11}},
+        {11, "x = x + 1", {12}},
+        {12, "y = x", {13}},
+        {13, "End", {}},
+    });
+    add_fn("reset", 20, 24, {
+        {20, "Start", {21}},
+        {21, "if (y > 0)", {22, 24}},
+        {22, "x = 0", {23}},
+        {23, "call inc", {24}},
+        {24, "End", {}},
+    });
+    add_fn("countdown", 30, 34, {
+        {30, "Start", {31}},
+        {31, "if (n > 0)", {32, 34}},
+        {32, "n = n - 1", {33}},
+        {33, "call countdown", {34}},
+        {34, "End", {}},
+    });
+    return prog;
+}
+
+// Chain of `blocks` counted loops over shared variables; every third loop has a
+// nested inner loop.  Used to benchmark the analyses on large CFGs.
+static CFG build_generated_cfg(int blocks) {
+    CFG cfg;
+    int next = 0;
+    auto add = [&](const string& stmt) {
+        int id = next++;
+        cfg.nodes[id] = Node{id, stmt, {}};
+        return id;
+    };
+    cfg.entry = add("Start");
+    int prev = cfg.entry;
+    for (int b = 0; b < blocks; ++b) {
+        string iv = "i" + to_string(b % 4), acc = "s" + to_string(b % 8);
+        int init = add(iv + " = 0");
+        int head = add("while (" + iv + " < " + to_string(10 + b % 5) + ")");
+        int body = add(acc + " = " + acc + " + " + iv);
+        cfg.nodes[prev].succ.push_back(init);
+        cfg.nodes[init].succ.push_back(head);
+        cfg.nodes[head].succ.push_back(body);
+        int last = body;
+        if (b % 3 == 0) {
+            int jinit = add("j = 0");
+            int jhead = add("while (j < 3)");
+            int jbody = add(acc + " = " + acc + " + j");
+            int jinc  = add("j = j + 1");
+            cfg.nodes[body].succ.push_back(jinit);
+            cfg.nodes[jinit].succ.push_back(jhead);
+            cfg.nodes[jhead].succ.push_back(jbody);
+            cfg.nodes[jbody].succ.push_back(jinc);
+            cfg.nodes[jinc].succ.push_back(jhead);
+            last = jhead; // false edge of the inner loop continues below
+        }
+        int inc = add(iv + " = " + iv + " + 1");
+        cfg.nodes[last].succ.push_back(inc);
+        cfg.nodes[inc].succ.push_back(head);
+        prev = head; // false edge leaves the loop
+    }
+    int print = add("print(s0)");
+    cfg.nodes[prev].succ.push_back(print);
+    cfg.exit = add("End");
+    cfg.nodes[print].succ.push_back(cfg.exit);
+    return cfg;
+}
+
+// `nfuncs` functions f0..f{n-1} over 16 globals: f_k calls its children
+// f_{2k+1}, f_{2k+2} plus one shared "library" function from the last 5%,
+// and every tenth sibling pair is mutually recursive (non-trivial SCCs).
+static Program build_generated_program(int nfuncs) {
+    Program prog;
+    prog.main_fn = "f0";
+    uint64_t seed = 12345;
+    auto rnd = [&](int n) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        return (int)((seed >> 33) % (uint64_t)n);
+    };
+    int next = 0;
+    for (int k = 0; k < nfuncs; ++k) {
+        string name = "f" + to_string(k);
+        CFG cfg;
+        auto add = [&](const string& stmt) {
+            int id = next++;
+            cfg.nodes[id] = Node{id, stmt, {}};
+            return id;
+        };
+        auto link = [&](int a, int b) { cfg.nodes[a].succ.push_back(b); };
+        auto g = [&]() { return "g" + to_string(rnd(16)); };
+
+        cfg.entry = add("Start");
+        int a = add(g() + " = " + g() + " + 1");
+        int head = add("while (" + g() + " < 10)");
+        int body = add(g() + " = " + g() + " + " + g());
+        link(cfg.entry, a);
+        link(a, head);
+        link(head, body);
+        int last = body;
+        vector<int> targets;
+        for (int child : {2 * k + 1, 2 * k + 2}) if (child < nfuncs) targets.push_back(child);
+        int lib_begin = nfuncs - max(1, nfuncs / 20);
+        if (k < lib_begin) targets.push_back(lib_begin + rnd(nfuncs - lib_begin));
+        if (k % 10 == 1 && k + 1 < nfuncs) targets.push_back(k + 1);
+        if (k % 10 == 2) targets.push_back(k - 1); // f(k-1) <-> f(k): recursion
+        for (int t : targets) {
+            int call = add("call f" + to_string(t));
+            link(last, call);
+            last = call;
+        }
+        link(last, head);
+        int after = add(g() + " = " + g());
+        link(head, after);
+        cfg.exit = add("End");
+        link(after, cfg.exit);
+
+        prog.funcs.push_back(name);
+        prog.cfgs[name] = move(cfg);
+    }
+    return prog;
 }
 
 // -------------------------
@@ -186,45 +1534,86 @@ struct HeapBlock {
     bool freed;
 };
 
+struct HeapStats {
+    uint64_t allocs = 0, frees = 0;
+    uint64_t lookups = 0;          // block-table lookups (every free/read/write)
+    uint64_t reads = 0, writes = 0;
+    uint64_t errors = 0;           // HeapError raised (UAF, double free, OOB, ...)
+    uint64_t live_blocks = 0, live_bytes = 0;
+    uint64_t peak_live_blocks = 0, peak_live_bytes = 0;
+};
+
 class Heap {
     long long next_addr = 1000; 
     unordered_map<long long, HeapBlock> blocks;
 
+    HeapBlock& lookup(long long addr, const char* what) {
+        ++stats.lookups;
+        auto it = blocks.find(addr);
+        if (it == blocks.end()) fail(string(what) + ": invalid address");
+        return it->second;
+    }
+
+    [[noreturn]] void fail(const string& msg) {
+        ++stats.errors;
+        throw HeapError(msg);
+    }
+
 public:
+    HeapStats stats;
+
     long long malloc_block(size_t size) {
         if (size == 0) throw invalid_argument("size must be > 0");
         long long addr = next_addr;
         next_addr += (long long)size;
         blocks[addr] = HeapBlock{size, vector<int>(size, 0), false};
+        ++stats.allocs;
+        ++stats.live_blocks;
+        stats.live_bytes += size * sizeof(int);
+        update_hwm(stats.peak_live_blocks, stats.live_blocks);
+        update_hwm(stats.peak_live_bytes, stats.live_bytes);
         return addr;
     }
 
     void free_block(long long addr) {
-        auto it = blocks.find(addr);
-        if (it == blocks.end()) throw HeapError("free: invalid address");
-        if (it->second.freed) throw HeapError("free: double free");
-        it->second.freed = true;
+        auto& b = lookup(addr, "free");
+        if (b.freed) fail("free: double free");
+        b.freed = true;
+        ++stats.frees;
+        --stats.live_blocks;
+        stats.live_bytes -= b.size * sizeof(int);
     }
 
     int read(long long addr, long long offset = 0) {
-        auto it = blocks.find(addr);
-        if (it == blocks.end()) throw HeapError("read: invalid address");
-        auto& b = it->second;
-        if (b.freed) throw HeapError("read: use-after-free");
-        if (offset < 0 || (size_t)offset >= b.size) throw HeapError("read: out-of-bounds");
+        auto& b = lookup(addr, "read");
+        ++stats.reads;
+        if (b.freed) fail("read: use-after-free");
+        if (offset < 0 || (size_t)offset >= b.size) fail("read: out-of-bounds");
         return b.data[(size_t)offset];
     }
 
     void write(long long addr, int value, long long offset = 0) {
-        auto it = blocks.find(addr);
-        if (it == blocks.end()) throw HeapError("write: invalid address");
-        auto& b = it->second;
-        if (b.freed) throw HeapError("write: use-after-free");
-        if (offset < 0 || (size_t)offset >= b.size) throw HeapError("write: out-of-bounds");
+        auto& b = lookup(addr, "write");
+        ++stats.writes;
+        if (b.freed) fail("write: use-after-free");
+        if (offset < 0 || (size_t)offset >= b.size) fail("write: out-of-bounds");
         b.data[(size_t)offset] = value;
     }
 };
 
+static void add_heap_stats(StatsReport& rep, const HeapStats& st) {
+    rep.add("heap", "allocs", (double)st.allocs);
+    rep.add("heap", "frees", (double)st.frees);
+    rep.add("heap", "lookups", (double)st.lookups);
+    rep.add("heap", "reads", (double)st.reads);
+    rep.add("heap", "writes", (double)st.writes);
+    rep.add("heap", "errors", (double)st.errors);
+    rep.add("heap", "live_blocks", (double)st.live_blocks);
+    rep.add("heap", "live_bytes", (double)st.live_bytes);
+    rep.add("heap", "peak_live_blocks", (double)st.peak_live_blocks);
+    rep.add("heap", "peak_live_bytes", (double)st.peak_live_bytes);
+}
+
 struct Pointer {
     long long base;
     long long offset;
@@ -273,7 +1662,193 @@ static string defs_to_string(const set<Def>& s) {
     return out.str();
 }
 
-int main() {
+static void add_interval_stats(StatsReport& rep, const IntervalResult& res, double ms) {
+    rep.add("interval", "node_evals", res.node_evals);
+    rep.add("interval", "narrowing_passes", res.narrowing_passes);
+    rep.add("interval", "widening_points", (double)res.widen_points.size());
+    rep.add("interval", "time_ms", ms);
+}
+
+static void add_ssa_stats(StatsReport& rep, const SSAForm& ssa, double ms) {
+    if (!rep.enabled) return;
+    size_t phis = 0, uses = 0;
+    for (auto& kv : ssa.phis) phis += kv.second.size();
+    for (auto& kv : ssa.use_value) uses += kv.second.size();
+    rep.add("ssa", "values", (double)ssa.values.size());
+    rep.add("ssa", "phis", (double)phis);
+    rep.add("ssa", "uses", (double)uses);
+    rep.add("ssa", "time_ms", ms);
+}
+
+static int bench_interval(int blocks, StatsReport& rep) {
+    CFG cfg = build_generated_cfg(blocks);
+    auto t0 = chrono::steady_clock::now();
+    auto res = interval_analysis(cfg);
+    auto t1 = chrono::steady_clock::now();
+    double ms = chrono::duration<double, milli>(t1 - t0).count();
+
+    cout << "=== Interval analysis benchmark (" << blocks << " loops) ===\n";
+    cout << "nodes=" << cfg.nodes.size()
+         << " back_edges=" << res.back_edges.size()
+         << " widening_points=" << res.widen_points.size() << "\n";
+    cout << "ascending node evaluations=" << res.node_evals
+         << " narrowing passes=" << res.narrowing_passes << "\n";
+    cout << "exit state: " << abs_state_to_string(res.IN[cfg.exit]) << "\n";
+    cout << "time=" << ms << " ms\n";
+    add_interval_stats(rep, res, ms);
+    return 0;
+}
+
+static void add_interproc_stats(StatsReport& rep, const InterprocResult& ip) {
+    if (!rep.enabled) return;
+    uint64_t max_rounds = 0;
+    for (auto& kv : ip.summaries) update_hwm(max_rounds, (uint64_t)kv.second.rounds);
+    rep.add("interproc", "functions", (double)ip.summaries.size());
+    rep.add("interproc", "sccs", (double)ip.cg.sccs.size());
+    rep.add("interproc", "levels", ip.levels);
+    rep.add("interproc", "analyses", (double)ip.analyses);
+    rep.add("interproc", "summary_uses", (double)ip.summary_uses);
+    rep.add("interproc", "max_rounds", (double)max_rounds);
+    rep.add("interproc", "time_ms", ip.ms);
+}
+
+static int bench_interproc(int nfuncs, unsigned threads, StatsReport& rep) {
+    Program prog = build_generated_program(nfuncs);
+    size_t nodes = 0;
+    for (auto& kv : prog.cfgs) nodes += kv.second.nodes.size();
+
+    auto seq = interprocedural_rd(prog, 1, false);
+    auto par = interprocedural_rd(prog, threads, false);
+    bool same = true;
+    for (auto& f : prog.funcs) if (!(seq.summaries.at(f) == par.summaries.at(f))) same = false;
+
+    size_t largest = 0;
+    for (auto& c : par.cg.sccs) largest = max(largest, c.size());
+    cout << "=== Interprocedural RD benchmark (" << nfuncs << " functions) ===\n";
+    cout << "nodes=" << nodes << " sccs=" << par.cg.sccs.size()
+         << " largest_scc=" << largest << " levels=" << par.levels << "\n";
+    cout << "function analyses=" << par.analyses
+         << " call sites served from summary cache=" << par.summary_uses << "\n";
+    cout << "1 thread : " << seq.ms << " ms\n";
+    cout << threads << " threads: " << par.ms << " ms\n";
+    cout << "summaries identical: " << (same ? "yes" : "NO") << "\n";
+    add_interproc_stats(rep, par);
+    return same ? 0 : 1;
+}
+
+static int bench_ssa(int blocks, StatsReport& rep) {
+    CFG cfg = build_generated_cfg(blocks);
+    auto ms_since = [](chrono::steady_clock::time_point t0) {
+        return chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+    };
+
+    // footprints are live heap deltas (every container the result owns)
+    HeapScope counting;
+    long long h0 = heap_live();
+    auto t0 = chrono::steady_clock::now();
+    auto rd = reaching_definitions(cfg);
+    double rd_ms = ms_since(t0);
+    long long rd_bytes = heap_live() - h0;
+
+    h0 = heap_live();
+    t0 = chrono::steady_clock::now();
+    auto ssa = build_ssa(cfg);
+    double ssa_ms = ms_since(t0);
+    long long ssa_bytes = heap_live() - h0;
+
+    size_t rd_entries = 0;
+    for (auto& kv : rd.IN) rd_entries += kv.second.size();
+    for (auto& kv : rd.OUT) rd_entries += kv.second.size();
+    size_t phi_args = 0;
+    for (auto& v : ssa.values) phi_args += v.args.size();
+
+    // "which defs reach this use", asked for every use in the program
+    size_t queries = 0, answered = 0;
+    t0 = chrono::steady_clock::now();
+    for (int b : ssa.rpo) {
+        auto it = ssa.use_value.find(b);
+        if (it == ssa.use_value.end()) continue;
+        for (auto& uv : it->second) { answered += ssa_reaching_defs(ssa, b, uv.first).size(); ++queries; }
+    }
+    double query_ms = ms_since(t0);
+
+    bool match = true;
+    for (int b : ssa.rpo) {
+        auto it = ssa.use_value.find(b);
+        if (it == ssa.use_value.end()) continue;
+        for (auto& uv : it->second) {
+            set<Def> want;
+            for (auto& d : rd.IN[b]) if (d.first == uv.first) want.insert(d);
+            if (ssa_reaching_defs(ssa, b, uv.first) != want) match = false;
+        }
+    }
+
+    // for comparison: densifying the answer for every SSA value up front
+    h0 = heap_live();
+    t0 = chrono::steady_clock::now();
+    auto vdefs = ssa_value_defs(ssa);
+    double eager_ms = ms_since(t0);
+    long long eager_bytes = heap_live() - h0;
+
+    cout << "=== SSA vs reaching_definitions() benchmark (" << blocks << " loops) ===\n";
+    cout << "nodes=" << cfg.nodes.size() << "\n";
+    cout << "RD : time=" << rd_ms << " ms, IN+OUT entries=" << rd_entries
+         << ", heap " << rd_bytes / 1024 << " KiB\n";
+    cout << "SSA: time=" << ssa_ms << " ms, values=" << ssa.values.size()
+         << " phi_args=" << phi_args << ", heap " << ssa_bytes / 1024 << " KiB\n";
+    cout << "reaching defs of all " << queries << " uses via SSA: " << query_ms << " ms ("
+         << answered << " defs), matches RD IN: " << (match ? "yes" : "NO") << "\n";
+    cout << "eager ssa_value_defs() for all values: " << eager_ms << " ms, heap "
+         << eager_bytes / 1024 << " KiB\n";
+    add_rd_stats(rep, rd.stats);
+    add_ssa_stats(rep, ssa, ssa_ms);
+    rep.add("ssa", "heap_bytes", (double)ssa_bytes);
+    rep.add("ssa", "query_ms", query_ms);
+    rep.add("rd", "heap_bytes", (double)rd_bytes);
+    return match ? 0 : 1;
+}
+
+static int run_demo(StatsReport& rep);
+
+int main(int argc, char** argv) {
+    // --stats / --stats=text / --stats=json may appear anywhere; report goes to stderr
+    string stats_fmt;
+    vector<string> args;
+    for (int k = 1; k < argc; ++k) {
+        string a = argv[k];
+        if (a == "--stats" || a == "--stats=text") stats_fmt = "text";
+        else if (a == "--stats=json") stats_fmt = "json";
+        else args.push_back(a);
+    }
+
+    StatsReport rep;
+    rep.enabled = !stats_fmt.empty();
+    int rc = 1;
+    if (args.empty()) {
+        rc = run_demo(rep);
+    } else if (args[0] == "bench_interval") {
+        int blocks = (args.size() >= 2) ? stoi(args[1]) : 1000;
+        rc = bench_interval(blocks, rep);
+    } else if (args[0] == "bench_ssa") {
+        int blocks = (args.size() >= 2) ? stoi(args[1]) : 200;
+        rc = bench_ssa(blocks, rep);
+    } else if (args[0] == "bench_interproc") {
+        int nfuncs = (args.size() >= 2) ? stoi(args[1]) : 2000;
+        unsigned threads = (args.size() >= 3) ? (unsigned)stoi(args[2]) : max(1u, thread::hardware_concurrency());
+        rc = bench_interproc(nfuncs, threads, rep);
+    } else {
+        cerr << "Usage:\n"
+             << "  ./problem [--stats[=json]]\n"
+             << "  ./problem bench_interval [loops] [--stats[=json]]\n"
+             << "  ./problem bench_ssa [loops] [--stats[=json]]\n"
+             << "  ./problem bench_interproc [functions] [threads] [--stats[=json]]\n";
+        return 1;
+    }
+    if (!stats_fmt.empty()) rep.print(cerr, stats_fmt == "json");
+    return rc;
+}
+
+static int run_demo(StatsReport& rep) {
     // (2) CFG
     CFG cfg = build_example_cfg();
     cout << "=== (2) CFG edges ===\n";
@@ -304,6 +1879,114 @@ int main() {
              << defs_to_string(rd.OUT[nid]) << "\n";
     }
 
+    // (5) Interval analysis
+    double iv_ms = 0;
+    IntervalResult iv;
+    {
+        ScopedTimer timer(iv_ms);
+        iv = interval_analysis(cfg);
+    }
+    cout << "\n=== (5) Interval analysis (widening + narrowing) ===\n";
+    cout << "back edges:";
+    for (auto& e : iv.back_edges) cout << " (" << e.first << " -> " << e.second << ")";
+    cout << "\nwidening points: {";
+    for (int h : iv.widen_points) cout << " " << h;
+    cout << " }\nWTO: " << wto_to_string(iv.wto) << "\n";
+    cout << "fixpoint after " << iv.node_evals << " node evaluations, "
+         << iv.narrowing_passes << " narrowing passes\n";
+    for (int nid : ids) {
+        const string& stmt = cfg.nodes[nid].stmt;
+        if (stmt == "Start" || stmt == "End") continue;
+        cout << "node " << setw(2) << right << nid
+             << " | " << left << setw(18) << stmt << " | IN = "
+             << abs_state_to_string(iv.IN[nid]) << "\n";
+    }
+
+    // (6) SSA + def-use chains
+    double ssa_ms = 0;
+    SSAForm ssa;
+    {
+        ScopedTimer timer(ssa_ms);
+        ssa = build_ssa(cfg);
+    }
+    cout << "\n=== (6) SSA form + def-use chains ===\n";
+    for (int nid : ids) {
+        const string& stmt = cfg.nodes[nid].stmt;
+        if (stmt == "Start" || stmt == "End") continue;
+        cout << "node " << setw(2) << right << nid << " | " << left << setw(18) << stmt << " |";
+        for (auto& [v, val] : ssa.phis[nid]) {
+            cout << " " << ssa.name(val) << " = phi(";
+            const auto& args = ssa.values[val].args;
+            for (size_t j = 0; j < args.size(); ++j) cout << (j ? ", " : "") << ssa.name(args[j]);
+            cout << ");";
+        }
+        for (auto& [v, val] : ssa.use_value[nid]) cout << " use " << v << " -> " << ssa.name(val) << ";";
+        auto d = ssa.def_value.find(nid);
+        if (d != ssa.def_value.end()) cout << " def " << ssa.name(d->second) << ";";
+        cout << "\n";
+    }
+    cout << "def-use chains:\n";
+    {
+        vector<int> order;
+        for (int v = 0; v < (int)ssa.values.size(); ++v) if (!ssa.values[v].uses.empty()) order.push_back(v);
+        sort(order.begin(), order.end(), [&](int a, int b) {
+            const auto& x = ssa.values[a]; const auto& y = ssa.values[b];
+            return make_pair(x.var, x.version) < make_pair(y.var, y.version);
+        });
+        for (int v : order) {
+            vector<int> us = ssa.values[v].uses;
+            sort(us.begin(), us.end());
+            cout << "  " << left << setw(6) << ssa.name(v) << " -> nodes {";
+            for (int u : us) cout << " " << u;
+            cout << " }\n";
+        }
+    }
+    {
+        cout << "defs reaching use of sum at node 6: " << defs_to_string(ssa_reaching_defs(ssa, 6, "sum")) << "\n";
+        auto derived = rd_out_from_ssa(cfg, ssa);
+        bool match = true;
+        for (int nid : ids) if (derived[nid] != rd.OUT[nid]) match = false;
+        cout << "RD OUT sets derived from SSA match reaching_definitions(): "
+             << (match ? "yes" : "NO") << "\n";
+    }
+
+    // (7) Interprocedural RD
+    Program prog = build_example_program();
+    auto ip = interprocedural_rd(prog, 2);
+    cout << "\n=== (7) Interprocedural RD (summaries, bottom-up over call-graph SCCs) ===\n";
+    cout << "call graph:";
+    for (auto& f : prog.funcs) {
+        cout << " " << f << " -> {";
+        for (auto& g : ip.cg.callees[f]) cout << " " << g;
+        cout << " };";
+    }
+    cout << "\nSCCs bottom-up:";
+    for (size_t c = 0; c < ip.cg.sccs.size(); ++c) {
+        cout << " [";
+        for (size_t k = 0; k < ip.cg.sccs[c].size(); ++k) cout << (k ? " " : "") << ip.cg.sccs[c][k];
+        cout << "]@L" << ip.cg.level[c];
+    }
+    cout << "\n";
+    for (auto& f : prog.funcs) {
+        const auto& fs = ip.summaries[f];
+        cout << "summary " << left << setw(9) << f << " GEN=" << defs_to_string(fs.gen)
+             << " MUST=" << str_set_to_string(fs.must) << " MOD=" << str_set_to_string(fs.mod)
+             << " REF=" << str_set_to_string(fs.ref) << " rounds=" << fs.rounds << "\n";
+    }
+    {
+        const CFG& mcfg = prog.cfgs.at(prog.main_fn);
+        vector<int> mids;
+        for (auto& kv : mcfg.nodes) mids.push_back(kv.first);
+        sort(mids.begin(), mids.end());
+        for (int nid : mids) {
+            const string& stmt = mcfg.nodes.at(nid).stmt;
+            if (stmt == "Start" || stmt == "End") continue;
+            cout << "main node " << setw(2) << right << nid
+                 << " | " << left << setw(16) << stmt << " | OUT = "
+                 << defs_to_string(ip.rd[prog.main_fn].OUT[nid]) << "\n";
+        }
+    }
+
     // (3)+(4) Memory + Pointer
     cout << "\n=== (3)+(4) Memory + Pointer demo ===\n";
     Stack stack;
@@ -329,5 +2012,11 @@ int main() {
     }
 
     stack.exit();
+
+    add_rd_stats(rep, rd.stats);
+    add_interval_stats(rep, iv, iv_ms);
+    add_ssa_stats(rep, ssa, ssa_ms);
+    add_interproc_stats(rep, ip);
+    add_heap_stats(rep, heap.stats);
     return 0;
 }
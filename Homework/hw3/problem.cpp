@@ -10,6 +10,19 @@
 #include <cmath>
 #include <cstdint>   // uint64_t
 #include <cstddef>   // size_t (tùy, nhưng nên có)
+#include <chrono>    // steady_clock (--stats)
+#include <iomanip>   // setw
+#include <fstream>   // trace files
+#include <iterator>  // istreambuf_iterator
+#include <cstring>   // memcpy, memcmp
+#include <tuple>     // tie
+#include <stdexcept> // runtime_error
+#ifndef _WIN32
+#include <fcntl.h>     // open
+#include <sys/mman.h>  // mmap, madvise
+#include <sys/stat.h>  // fstat
+#include <unistd.h>    // close
+#endif
 
 
 using std::string;
@@ -23,6 +36,57 @@ static string join(const std::vector<string>& v, const char* sep) {
     return oss.str();
 }
 
+// -------------------- Perf counters (--stats) --------------------
+//
+// Plain counters bumped inline (cheap enough to leave on); the report is only
+// formatted when --stats is given.
+struct ScopedTimer {
+    double& acc_ms;
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    explicit ScopedTimer(double& acc) : acc_ms(acc) {}
+    ~ScopedTimer() {
+        acc_ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    }
+};
+
+struct StatsReport {
+    struct Entry { string section, name; double value; };
+    std::vector<Entry> entries;
+    bool enabled = false; // set by main only when --stats is given
+
+    void add(const string& section, const string& name, double value) {
+        if (enabled) entries.push_back({section, name, value});
+    }
+
+    static void print_value(std::ostream& out, double v) {
+        if (v == (double)(long long)v) out << (long long)v;
+        else out << v;
+    }
+
+    void print(std::ostream& out, bool json) const {
+        if (!json) {
+            out << "=== STATS ===\n";
+            for (auto& e : entries) {
+                out << std::left << std::setw(28) << (e.section + "." + e.name) << " ";
+                print_value(out, e.value);
+                out << "\n";
+            }
+            return;
+        }
+        out << "{";
+        for (size_t i = 0; i < entries.size(); ++i) {
+            bool open = (i == 0 || entries[i - 1].section != entries[i].section);
+            bool close = (i + 1 == entries.size() || entries[i + 1].section != entries[i].section);
+            if (open) out << (i ? ", " : "") << "\"" << entries[i].section << "\": {";
+            else out << ", ";
+            out << "\"" << entries[i].name << "\": ";
+            print_value(out, entries[i].value);
+            if (close) out << "}";
+        }
+        out << "}\n";
+    }
+};
+
 struct ExecContext {
     std::vector<string> stack;
 
@@ -49,6 +113,43 @@ struct TraceEvent {
     std::unordered_map<uint64_t, int> use_def_mem;
 };
 
+// Delta checkpoint taken *before* event `eid` executes: the variables and
+// memory cells whose last observed value changed since the previous
+// checkpoint. Folding checkpoints [0..k] in order gives the full state at k.
+struct Checkpoint {
+    int eid = -1;
+    std::unordered_map<string, long long> vars;
+    std::unordered_map<uint64_t, long long> mem;
+};
+
+struct ReplayResult {
+    int target = -1;       // event we stopped in front of
+    int checkpoint = -1;   // eid of the checkpoint we restarted from (-1: none)
+    int replayed = 0;      // number of events re-applied after the checkpoint
+    std::unordered_map<string, long long> vars;
+    std::unordered_map<uint64_t, long long> mem;
+};
+
+struct TracerStats {
+    uint64_t events = 0;
+    uint64_t var_reads = 0, var_writes = 0;
+    uint64_t mem_reads = 0, mem_writes = 0;
+    uint64_t checkpoints = 0;
+    uint64_t replays = 0, replayed_events = 0;
+    uint64_t slice_visits = 0;   // events popped by the slicer (incl. already seen)
+};
+
+// Rough heap footprint of one event (strings, vectors, use-def maps).
+static size_t approx_event_bytes(const TraceEvent& e) {
+    const size_t map_node = 4 * sizeof(void*); // bucket + node overhead per entry
+    size_t b = sizeof(TraceEvent) + e.idx.capacity();
+    b += e.reads.capacity() * sizeof(e.reads[0]) + e.writes.capacity() * sizeof(e.writes[0]);
+    b += e.mem_reads.capacity() * sizeof(e.mem_reads[0]) + e.mem_writes.capacity() * sizeof(e.mem_writes[0]);
+    b += e.use_def_var.size() * (sizeof(std::pair<string, int>) + map_node);
+    b += e.use_def_mem.size() * (sizeof(std::pair<uint64_t, int>) + map_node);
+    return b;
+}
+
 struct Tracer {
     ExecContext* ctx = nullptr;
     std::vector<TraceEvent> evs;
@@ -56,6 +157,24 @@ struct Tracer {
     std::unordered_map<string, int> last_def_var;   
     std::unordered_map<uint64_t, int> last_def_mem; 
 
+    // Execution index -> event ids: (ctx id, stmt) -> every instance in order.
+    // Built lazily by find_event() over the events added since the last lookup,
+    // so runs that never query pay nothing; index_events = false keeps no index
+    // at all and find_event() falls back to a linear scan.
+    bool index_events = true;
+    mutable std::unordered_map<string, int> ctx_ids;
+    mutable std::map<std::pair<int, int>, std::vector<int>> by_index;
+    mutable size_t indexed = 0;
+
+    // Periodic delta checkpoints (0 disables them, and the tracer then keeps
+    // no running state) + the changes since the last one.
+    int checkpoint_every = 1024;
+    std::vector<Checkpoint> checkpoints;
+    std::unordered_map<string, long long> dirty_var;
+    std::unordered_map<uint64_t, long long> dirty_mem;
+
+    mutable TracerStats stats; // also bumped by the const query methods
+
     explicit Tracer(ExecContext* c) : ctx(c) {}
 
     int begin_stmt(int stmt_id) {
@@ -63,6 +182,13 @@ struct Tracer {
         e.eid = (int)evs.size();
         e.stmt = stmt_id;
         e.idx = (ctx ? ctx->str() : "<main>");
+        if (checkpoint_every > 0 && e.eid % checkpoint_every == 0) {
+            checkpoints.push_back(Checkpoint{e.eid, std::move(dirty_var), std::move(dirty_mem)});
+            dirty_var.clear();
+            dirty_mem.clear();
+            ++stats.checkpoints;
+        }
+        ++stats.events;
         evs.push_back(std::move(e));
         return (int)evs.size() - 1;
     }
@@ -70,6 +196,7 @@ struct Tracer {
     void read_var(int eid, const string& v, long long val) {
         auto& e = evs.at(eid);
         e.reads.push_back({v, val});
+        ++stats.var_reads;
         auto it = last_def_var.find(v);
         e.use_def_var[v] = (it == last_def_var.end() ? -1 : it->second);
     }
@@ -77,11 +204,13 @@ struct Tracer {
     void write_var(int eid, const string& v, long long val) {
         auto& e = evs.at(eid);
         e.writes.push_back({v, val});
+        ++stats.var_writes;
     }
 
     void read_mem(int eid, uint64_t addr, long long val) {
         auto& e = evs.at(eid);
         e.mem_reads.push_back({addr, val});
+        ++stats.mem_reads;
         auto it = last_def_mem.find(addr);
         e.use_def_mem[addr] = (it == last_def_mem.end() ? -1 : it->second);
     }
@@ -89,12 +218,69 @@ struct Tracer {
     void write_mem(int eid, uint64_t addr, long long val) {
         auto& e = evs.at(eid);
         e.mem_writes.push_back({addr, val});
+        ++stats.mem_writes;
     }
 
     void end_stmt(int eid) {
         auto& e = evs.at(eid);
         for (auto& [v, _val] : e.writes) last_def_var[v] = eid;
         for (auto& [addr, _val] : e.mem_writes) last_def_mem[addr] = eid;
+        if (checkpoint_every > 0) apply_event(e, dirty_var, dirty_mem);
+    }
+
+    // Fold the values an event observed (reads) and produced (writes) into a state.
+    static void apply_event(const TraceEvent& e,
+                            std::unordered_map<string, long long>& vars,
+                            std::unordered_map<uint64_t, long long>& mem) {
+        for (auto& [v, val] : e.reads) vars[v] = val;
+        for (auto& [v, val] : e.writes) vars[v] = val;
+        for (auto& [a, val] : e.mem_reads) mem[a] = val;
+        for (auto& [a, val] : e.mem_writes) mem[a] = val;
+    }
+
+    // O(log n) lookup of the `instance`-th event of stmt_id under execution index idx
+    // (after the index has caught up with the trace).
+    int find_event(const string& idx, int stmt_id, int instance = 0) const {
+        if (instance < 0) return -1;
+        if (!index_events) {
+            for (auto& e : evs)
+                if (e.stmt == stmt_id && e.idx == idx && instance-- == 0) return e.eid;
+            return -1;
+        }
+        for (; indexed < evs.size(); ++indexed) {
+            const TraceEvent& e = evs[indexed];
+            int cid = ctx_ids.emplace(e.idx, (int)ctx_ids.size()).first->second;
+            by_index[{cid, e.stmt}].push_back(e.eid);
+        }
+        auto c = ctx_ids.find(idx);
+        if (c == ctx_ids.end()) return -1;
+        auto it = by_index.find({c->second, stmt_id});
+        if (it == by_index.end() || instance >= (int)it->second.size()) return -1;
+        return it->second[instance];
+    }
+
+    // State right before target_eid: rebuild the nearest checkpoint at or before
+    // it from the deltas, then replay only the events in between.
+    ReplayResult replay_to(int target_eid) const {
+        ReplayResult r;
+        if (target_eid < 0 || target_eid >= (int)evs.size()) return r;
+        r.target = target_eid;
+
+        auto it = std::upper_bound(checkpoints.begin(), checkpoints.end(), target_eid,
+                                   [](int eid, const Checkpoint& c) { return eid < c.eid; });
+        int from = 0;
+        for (auto c = checkpoints.begin(); c != it; ++c) {
+            for (auto& [v, val] : c->vars) r.vars[v] = val;
+            for (auto& [a, val] : c->mem) r.mem[a] = val;
+            from = r.checkpoint = c->eid;
+        }
+        for (int i = from; i < target_eid; ++i) {
+            apply_event(evs[i], r.vars, r.mem);
+            ++r.replayed;
+        }
+        ++stats.replays;
+        stats.replayed_events += r.replayed;
+        return r;
     }
 
     void dump_trace(bool show_mem = true) const {
@@ -135,6 +321,7 @@ struct Tracer {
 
         while (!st.empty()) {
             int eid = st.back(); st.pop_back();
+            ++stats.slice_visits;
             if (eid < 0 || eid >= (int)evs.size()) continue;
             if (seen_eids.count(eid)) continue;
             seen_eids.insert(eid);
@@ -154,6 +341,26 @@ struct Tracer {
         return slice_stmt_ids;
     }
 
+    // trace_ms: wall time of the traced run, for the events/sec figure
+    void add_stats(StatsReport& rep, double trace_ms) const {
+        if (!rep.enabled) return; // the byte walk is O(events)
+        size_t bytes = 0;
+        for (auto& e : evs) bytes += approx_event_bytes(e);
+        rep.add("tracer", "events", (double)stats.events);
+        rep.add("tracer", "var_reads", (double)stats.var_reads);
+        rep.add("tracer", "var_writes", (double)stats.var_writes);
+        rep.add("tracer", "mem_reads", (double)stats.mem_reads);
+        rep.add("tracer", "mem_writes", (double)stats.mem_writes);
+        rep.add("tracer", "checkpoints", (double)stats.checkpoints);
+        rep.add("tracer", "replays", (double)stats.replays);
+        rep.add("tracer", "replayed_events", (double)stats.replayed_events);
+        rep.add("tracer", "slice_visits", (double)stats.slice_visits);
+        rep.add("tracer", "trace_bytes", (double)bytes);
+        rep.add("tracer", "bytes_per_event", evs.empty() ? 0.0 : (double)bytes / evs.size());
+        rep.add("tracer", "trace_ms", trace_ms);
+        rep.add("tracer", "events_per_sec", trace_ms > 0 ? stats.events * 1000.0 / trace_ms : 0.0);
+    }
+
     int last_event_of_stmt(int stmt_id) const {
         for (int i = (int)evs.size() - 1; i >= 0; --i) {
             if (evs[i].stmt == stmt_id) return i;
@@ -176,10 +383,12 @@ struct Tracer {
 //  S9: z = 2 * (*p)         // memory read via deref p
 //  S10: print(z)
 //
-static void demo_trace_and_slice(int input) {
-    ExecContext ctx;
-    Tracer tr(&ctx);
+static double ms_since(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
 
+// Runs the program above under `tr` and returns the printed z.
+static int run_slice_program(ExecContext& ctx, Tracer& tr, int input) {
     int z = 0, a = 0, b = 0, i = 0;
     int* p = nullptr;
 
@@ -285,8 +494,17 @@ static void demo_trace_and_slice(int input) {
         int eid = tr.begin_stmt(10);
         tr.read_var(eid, "z", z);
         tr.end_stmt(eid);
-        std::cout << "Program output: z=" << z << "\n";
     }
+    return z;
+}
+
+static void demo_trace_and_slice(int input, StatsReport& rep) {
+    ExecContext ctx;
+    Tracer tr(&ctx);
+    auto t0 = std::chrono::steady_clock::now();
+    int z = run_slice_program(ctx, tr, input);
+    double trace_ms = ms_since(t0);
+    std::cout << "Program output: z=" << z << "\n";
 
     tr.dump_trace(true);
 
@@ -298,14 +516,20 @@ static void demo_trace_and_slice(int input) {
     std::cout << "{ ";
     for (int s : slice_stmt_ids) std::cout << s << " ";
     std::cout << "}\n";
+
+    tr.add_stats(rep, trace_ms);
 }
 
 // -------------------- Part (3): Execution Indexing demo --------------------
 //
 // Idea: use execution index for setting breakpoints / reproducing a specific instance. :contentReference[oaicite:6]{index=6}
-static void demo_execution_indexing() {
+// The (index, stmt) pair is looked up in the tracer and the state in front of that
+// event is rebuilt from the nearest checkpoint.
+static void demo_execution_indexing(const string& target_idx, int target_stmt, StatsReport& rep) {
     ExecContext ctx;
     Tracer tr(&ctx);
+    tr.checkpoint_every = 3; // tiny trace: checkpoint often; E4 (the default target) replays E3
+    auto t0 = std::chrono::steady_clock::now();
 
     auto foo = [&](int& x, int call_id) {
         ctx.push("foo#" + std::to_string(call_id));
@@ -361,17 +585,38 @@ static void demo_execution_indexing() {
         tr.end_stmt(eid);
         std::cout << "Execution-index demo output: x=" << x << "\n";
     }
+    double trace_ms = ms_since(t0);
 
     std::cout << "=== EXECUTION INDEXES (each event has a context index) ===\n";
     for (auto& e : tr.evs) {
         std::cout << "E" << e.eid << " S" << e.stmt << " " << e.idx << "\n";
     }
+
+    std::cout << "=== REPLAY to " << target_idx << " S" << target_stmt << " ===\n";
+    int eid = tr.find_event(target_idx, target_stmt);
+    if (eid < 0) {
+        std::cout << "no event with this execution index\n";
+        tr.add_stats(rep, trace_ms);
+        return;
+    }
+    auto r = tr.replay_to(eid);
+    std::cout << "lookup -> E" << eid << "\n";
+    if (r.checkpoint >= 0) std::cout << "nearest checkpoint: E" << r.checkpoint;
+    else std::cout << "no checkpoint, from the start";
+    std::cout << " (replayed " << r.replayed << " events)\n";
+    std::map<string, long long> vars(r.vars.begin(), r.vars.end());
+    std::cout << "state before E" << eid << ": ";
+    for (auto& [v, val] : vars) std::cout << v << "=" << val << " ";
+    std::cout << "\n";
+
+    tr.add_stats(rep, trace_ms);
 }
 
 // -------------------- Part (4): Fault Localization demo --------------------
 //
 // Idea: suspiciousness ranking / coverage-based fault localization. :contentReference[oaicite:7]{index=7}
-static void demo_fault_localization() {
+static void demo_fault_localization(StatsReport& rep) {
+    auto t0 = std::chrono::steady_clock::now();
     struct Test {
         int x, lo, hi;
         int expected;
@@ -458,32 +703,925 @@ static void demo_fault_localization() {
     }
 
     std::cout << "Expected: statement S204 is the most suspicious (buggy branch).\n";
+
+    size_t covered = 0;
+    for (auto& r : runs) covered += r.cov.size();
+    rep.add("fault_loc", "tests", (double)runs.size());
+    rep.add("fault_loc", "failing", total_fail);
+    rep.add("fault_loc", "coverage_entries", (double)covered);
+    rep.add("fault_loc", "stmts_scored", (double)scored.size());
+    rep.add("fault_loc", "time_ms", ms_since(t0));
+}
+
+// -------------------- Part (5): Saved traces + offline slicing --------------------
+//
+// Record once, slice many times later (possibly on another machine). The file
+// is laid out so a reader can jump straight to any event:
+//
+//   header   : magic "HW3TRC03", n_events, index_off, names_off, ctx_off, stmts_off (u64)
+//   records  : i32 stmt, u32 ctx_id, u32 #reads, #writes, #mem_reads, #mem_writes
+//              reads      {u32 name_id, i32 def_eid, i64 val}
+//              writes     {u32 name_id, i64 val}
+//              mem_reads  {u64 addr, i32 def_eid, i64 val}
+//              mem_writes {u64 addr, i64 val}
+//   index    : u64 offset of every record
+//   names    : u32 count, then {u32 len, bytes} per variable name
+//   contexts : u32 count, u64 offsets[count + 1], then the execution-index bytes
+//   stmts    : u32 count, then {i32 stmt, u32 name_id, i32 last_eid} sorted by
+//              (stmt, name_id): the last event of each stmt reading or writing each variable,
+//              so a criterion <S, v> is a binary search instead of a scan
+//
+// All integers are host-endian; the file is meant for the same architecture.
+// Every offset read from the file is checked against its size before use;
+// a bad one is reported as "truncated trace".
+namespace tracefile {
+
+const char MAGIC[8] = {'H', 'W', '3', 'T', 'R', 'C', '0', '3'};
+const size_t HEADER_SZ = 8 + 5 * 8;
+const size_t REC_HDR_SZ = 6 * 4;
+const size_t READ_SZ = 4 + 4 + 8;
+const size_t WRITE_SZ = 4 + 8;
+const size_t MREAD_SZ = 8 + 4 + 8;
+const size_t MWRITE_SZ = 8 + 8;
+const size_t STMT_ENT_SZ = 4 + 4 + 4;
+
+template <class T> static void put(string& buf, T v) {
+    buf.append(reinterpret_cast<const char*>(&v), sizeof(T));
+}
+
+template <class T> static T load(const unsigned char* p) {
+    T v;
+    std::memcpy(&v, p, sizeof(T));
+    return v;
+}
+
+} // namespace tracefile
+
+static bool save_trace(const Tracer& tr, const string& path, string& err) {
+    using namespace tracefile;
+    std::unordered_map<string, uint32_t> name_id, ctx_id;
+    std::vector<string> names, ctxs;
+    auto intern = [](std::unordered_map<string, uint32_t>& ids, std::vector<string>& tab, const string& s) {
+        auto it = ids.find(s);
+        if (it != ids.end()) return it->second;
+        ids.emplace(s, (uint32_t)tab.size());
+        tab.push_back(s);
+        return (uint32_t)tab.size() - 1;
+    };
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) { err = "cannot open " + path + " for writing"; return false; }
+
+    string buf(HEADER_SZ, '\0');
+    std::vector<uint64_t> index;
+    index.reserve(tr.evs.size());
+    std::map<std::pair<int32_t, uint32_t>, int32_t> last_use; // (stmt, name_id) -> eid
+    uint64_t pos = 0;
+    for (auto& e : tr.evs) {
+        index.push_back(pos + buf.size());
+        put<int32_t>(buf, e.stmt);
+        put<uint32_t>(buf, intern(ctx_id, ctxs, e.idx));
+        put<uint32_t>(buf, (uint32_t)e.reads.size());
+        put<uint32_t>(buf, (uint32_t)e.writes.size());
+        put<uint32_t>(buf, (uint32_t)e.mem_reads.size());
+        put<uint32_t>(buf, (uint32_t)e.mem_writes.size());
+        for (auto& [v, val] : e.reads) {
+            auto it = e.use_def_var.find(v);
+            uint32_t id = intern(name_id, names, v);
+            last_use[{e.stmt, id}] = e.eid;
+            put<uint32_t>(buf, id);
+            put<int32_t>(buf, it == e.use_def_var.end() ? -1 : it->second);
+            put<int64_t>(buf, val);
+        }
+        for (auto& [v, val] : e.writes) {
+            uint32_t id = intern(name_id, names, v);
+            last_use[{e.stmt, id}] = e.eid;
+            put<uint32_t>(buf, id);
+            put<int64_t>(buf, val);
+        }
+        for (auto& [a, val] : e.mem_reads) {
+            auto it = e.use_def_mem.find(a);
+            put<uint64_t>(buf, a);
+            put<int32_t>(buf, it == e.use_def_mem.end() ? -1 : it->second);
+            put<int64_t>(buf, val);
+        }
+        for (auto& [a, val] : e.mem_writes) {
+            put<uint64_t>(buf, a);
+            put<int64_t>(buf, val);
+        }
+        if (buf.size() >= (1u << 20)) { // flush in 1 MiB chunks
+            out.write(buf.data(), (std::streamsize)buf.size());
+            pos += buf.size();
+            buf.clear();
+        }
+    }
+
+    uint64_t index_off = pos + buf.size();
+    for (uint64_t off : index) put<uint64_t>(buf, off);
+
+    uint64_t names_off = pos + buf.size();
+    put<uint32_t>(buf, (uint32_t)names.size());
+    for (auto& n : names) { put<uint32_t>(buf, (uint32_t)n.size()); buf += n; }
+
+    uint64_t ctx_off = pos + buf.size();
+    put<uint32_t>(buf, (uint32_t)ctxs.size());
+    uint64_t acc = 0;
+    for (auto& c : ctxs) { put<uint64_t>(buf, acc); acc += c.size(); }
+    put<uint64_t>(buf, acc);
+    for (auto& c : ctxs) buf += c;
+
+    uint64_t stmts_off = pos + buf.size();
+    put<uint32_t>(buf, (uint32_t)last_use.size());
+    for (auto& [key, eid] : last_use) {
+        put<int32_t>(buf, key.first);
+        put<uint32_t>(buf, key.second);
+        put<int32_t>(buf, eid);
+    }
+    out.write(buf.data(), (std::streamsize)buf.size());
+
+    string hdr(MAGIC, sizeof(MAGIC));
+    put<uint64_t>(hdr, (uint64_t)tr.evs.size());
+    put<uint64_t>(hdr, index_off);
+    put<uint64_t>(hdr, names_off);
+    put<uint64_t>(hdr, ctx_off);
+    put<uint64_t>(hdr, stmts_off);
+    out.seekp(0);
+    out.write(hdr.data(), (std::streamsize)hdr.size());
+    if (!out) { err = "write failed: " + path; return false; }
+    return true;
+}
+
+// Read-only view of a saved trace. The file is mmap'ed (MADV_RANDOM, so no
+// read-ahead) and records are decoded only when the slicer reaches them.
+class MappedTrace {
+    const unsigned char* base = nullptr;
+    size_t len = 0;
+#ifdef _WIN32
+    std::vector<unsigned char> owned; // no mmap here: fall back to reading the file
+#endif
+    uint64_t n = 0, index_off = 0, names_off = 0, ctx_off = 0, stmts_off = 0;
+    uint32_t n_ctx = 0, n_stmt_ents = 0;
+    std::vector<string> names;        // small: parsed eagerly
+    mutable std::set<uint64_t> pages; // 4 KiB pages the queries have touched
+
+    void touch(uint64_t off, uint64_t size) const {
+        for (uint64_t pg = off / 4096; pg <= (off + size - 1) / 4096; ++pg) pages.insert(pg);
+    }
+
+    // [off, off + size) must lie inside the file
+    bool fits(uint64_t off, uint64_t size) const { return off <= len && size <= len - off; }
+    void need(uint64_t off, uint64_t size, const char* what) const {
+        if (!fits(off, size)) throw std::runtime_error(string("truncated trace: ") + what);
+    }
+
+public:
+    MappedTrace() = default;
+    MappedTrace(const MappedTrace&) = delete;
+    MappedTrace& operator=(const MappedTrace&) = delete;
+    ~MappedTrace() {
+#ifndef _WIN32
+        if (base) munmap(const_cast<unsigned char*>(base), len);
+#endif
+    }
+
+    bool open(const string& path, string& err) {
+        using namespace tracefile;
+#ifndef _WIN32
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) { err = "cannot open " + path; return false; }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size < (off_t)HEADER_SZ) { ::close(fd); err = "not a trace file: " + path; return false; }
+        len = (size_t)st.st_size;
+        void* m = mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (m == MAP_FAILED) { err = "mmap failed: " + path; return false; }
+        madvise(m, len, MADV_RANDOM);
+        base = static_cast<const unsigned char*>(m);
+#else
+        std::ifstream in(path, std::ios::binary);
+        if (!in) { err = "cannot open " + path; return false; }
+        owned.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        base = owned.data();
+        len = owned.size();
+        if (len < HEADER_SZ) { err = "not a trace file: " + path; return false; }
+#endif
+        if (std::memcmp(base, MAGIC, sizeof(MAGIC)) != 0) { err = "bad magic: " + path; return false; }
+        n = load<uint64_t>(base + 8);
+        index_off = load<uint64_t>(base + 16);
+        names_off = load<uint64_t>(base + 24);
+        ctx_off = load<uint64_t>(base + 32);
+        stmts_off = load<uint64_t>(base + 40);
+        err = "truncated trace: " + path;
+        if (!fits(index_off, 0) || n > (len - index_off) / 8 || !fits(names_off, 4) || !fits(ctx_off, 4)
+            || !fits(stmts_off, 4)) return false;
+
+        uint64_t p = names_off;
+        uint32_t cnt = load<uint32_t>(base + p);
+        p += 4;
+        names.clear();
+        for (uint32_t k = 0; k < cnt; ++k) {
+            if (!fits(p, 4)) return false;
+            uint32_t l = load<uint32_t>(base + p);
+            if (!fits(p + 4, l)) return false;
+            names.emplace_back(reinterpret_cast<const char*>(base + p + 4), l);
+            p += 4 + l;
+        }
+
+        // context table: offsets must be in the file and end inside it
+        n_ctx = load<uint32_t>(base + ctx_off);
+        if (!fits(ctx_off + 4, ((uint64_t)n_ctx + 1) * 8)) return false;
+        uint64_t ctx_bytes = load<uint64_t>(base + ctx_off + 4 + (uint64_t)n_ctx * 8);
+        if (!fits(ctx_off + 4 + ((uint64_t)n_ctx + 1) * 8, ctx_bytes)) return false;
+
+        n_stmt_ents = load<uint32_t>(base + stmts_off);
+        if (!fits(stmts_off + 4, (uint64_t)n_stmt_ents * STMT_ENT_SZ)) return false;
+        err.clear();
+        pages.clear();
+        return true;
+    }
+
+    int size() const { return (int)n; }
+    size_t file_bytes() const { return len; }
+    size_t pages_total() const { return (len + 4095) / 4096; }
+    size_t pages_touched() const { return pages.size(); }
+
+    int name_id(const string& v) const {
+        for (size_t k = 0; k < names.size(); ++k) if (names[k] == v) return (int)k;
+        return -1;
+    }
+
+    // Throws std::runtime_error("truncated trace: ...") if the record leaves the file.
+    const unsigned char* record(int eid) const {
+        using namespace tracefile;
+        if (eid < 0 || (uint64_t)eid >= n) throw std::runtime_error("event id out of range");
+        touch(index_off + (uint64_t)eid * 8, 8);
+        uint64_t off = load<uint64_t>(base + index_off + (uint64_t)eid * 8);
+        need(off, REC_HDR_SZ, "record header");
+        const unsigned char* r = base + off;
+        uint64_t sz = REC_HDR_SZ + (uint64_t)load<uint32_t>(r + 8) * READ_SZ
+                    + (uint64_t)load<uint32_t>(r + 12) * WRITE_SZ
+                    + (uint64_t)load<uint32_t>(r + 16) * MREAD_SZ + (uint64_t)load<uint32_t>(r + 20) * MWRITE_SZ;
+        need(off, sz, "record body");
+        touch(off, sz);
+        return r;
+    }
+
+    int stmt_of(int eid) const { return tracefile::load<int32_t>(record(eid)); }
+
+    string context_of(int eid) const {
+        using namespace tracefile;
+        uint32_t id = load<uint32_t>(record(eid) + 4);
+        if (id >= n_ctx) throw std::runtime_error("truncated trace: context id");
+        const unsigned char* offs = base + ctx_off + 4;
+        uint64_t b = load<uint64_t>(offs + (uint64_t)id * 8), e = load<uint64_t>(offs + ((uint64_t)id + 1) * 8);
+        uint64_t bytes_off = ctx_off + 4 + ((uint64_t)n_ctx + 1) * 8;
+        if (b > e || !fits(bytes_off + b, e - b)) throw std::runtime_error("truncated trace: context bytes");
+        const unsigned char* bytes = base + bytes_off;
+        touch(bytes_off + b, std::max<uint64_t>(1, e - b));
+        return string(reinterpret_cast<const char*>(bytes + b), e - b);
+    }
+
+    // criterion <S, v>: the last execution of S that reads or writes v, by binary search
+    // over the stmts table (only the probed entries are paged in)
+    int last_event_using(int stmt_id, int var_id) const {
+        using namespace tracefile;
+        auto entry = [&](uint64_t k) {
+            uint64_t off = stmts_off + 4 + k * STMT_ENT_SZ;
+            touch(off, STMT_ENT_SZ);
+            return base + off;
+        };
+        auto key = [&](uint64_t k) {
+            const unsigned char* p = entry(k);
+            return std::make_pair(load<int32_t>(p), (int64_t)load<uint32_t>(p + 4));
+        };
+        auto want = std::make_pair((int32_t)stmt_id, (int64_t)var_id);
+        uint64_t lo = 0, hi = n_stmt_ents;
+        while (lo < hi) {
+            uint64_t mid = lo + (hi - lo) / 2;
+            if (key(mid) < want) lo = mid + 1;
+            else hi = mid;
+        }
+        if (lo == n_stmt_ents || key(lo) != want) return -1;
+        int eid = load<int32_t>(entry(lo) + 8);
+        if (eid < 0 || (uint64_t)eid >= n) throw std::runtime_error("truncated trace: stmts table");
+        return eid;
+    }
+
+    // Same walk as Tracer::thin_dynamic_slice_stmt_ids_from_event, over the file.
+    std::set<int> thin_slice_from_event(int start_eid, int* visited = nullptr) const {
+        using namespace tracefile;
+        std::unordered_set<int> seen_eids;
+        std::set<int> slice_stmt_ids;
+        std::vector<int> st{start_eid};
+        while (!st.empty()) {
+            int eid = st.back(); st.pop_back();
+            if (eid < 0 || eid >= (int)n) continue;
+            if (!seen_eids.insert(eid).second) continue;
+
+            const unsigned char* r = record(eid);
+            slice_stmt_ids.insert(load<int32_t>(r));
+            uint32_t nr = load<uint32_t>(r + 8), nw = load<uint32_t>(r + 12), nmr = load<uint32_t>(r + 16);
+            const unsigned char* p = r + REC_HDR_SZ;
+            for (uint32_t k = 0; k < nr; ++k, p += READ_SZ) {
+                int def = load<int32_t>(p + 4);
+                if (def != -1) st.push_back(def);
+            }
+            p += nw * WRITE_SZ;
+            for (uint32_t k = 0; k < nmr; ++k, p += MREAD_SZ) {
+                int def = load<int32_t>(p + 8);
+                if (def != -1) st.push_back(def);
+            }
+        }
+        if (visited) *visited = (int)seen_eids.size();
+        return slice_stmt_ids;
+    }
+};
+
+// "<S10, z>" / "S10,z" / "10 z" -> (10, "z")
+static bool parse_criterion(const string& text, int& stmt_id, string& var) {
+    string t;
+    for (char c : text) t += (c == '<' || c == '>' || c == ',') ? ' ' : c;
+    std::istringstream iss(t);
+    string s;
+    if (!(iss >> s >> var)) return false;
+    if (!s.empty() && (s[0] == 'S' || s[0] == 's')) s = s.substr(1);
+    try { stmt_id = std::stoi(s); } catch (...) { return false; }
+    return true;
+}
+
+static void print_slice(const std::set<int>& ids) {
+    std::cout << "{ ";
+    for (int s : ids) std::cout << s << " ";
+    std::cout << "}\n";
+}
+
+static int demo_trace_save(int input, const string& path, StatsReport& rep) {
+    ExecContext ctx;
+    Tracer tr(&ctx);
+    auto t0 = std::chrono::steady_clock::now();
+    int z = run_slice_program(ctx, tr, input);
+    double trace_ms = ms_since(t0);
+    std::cout << "Program output: z=" << z << "\n";
+
+    string err;
+    double save_ms = 0;
+    {
+        ScopedTimer timer(save_ms);
+        if (!save_trace(tr, path, err)) { std::cerr << err << "\n"; return 1; }
+    }
+    std::cout << "saved " << tr.evs.size() << " events to " << path << "\n";
+    std::cout << "=== THIN DYNAMIC SLICE (in-process) for criterion <S10, z> ===\n";
+    print_slice(tr.thin_dynamic_slice_stmt_ids_from_event(tr.last_event_of_stmt(10)));
+
+    tr.add_stats(rep, trace_ms);
+    rep.add("trace_file", "save_ms", save_ms);
+    return 0;
+}
+
+static int demo_slice_offline(const string& path, const string& criterion, StatsReport& rep) {
+    int stmt_id = -1;
+    string var;
+    if (!parse_criterion(criterion, stmt_id, var)) {
+        std::cerr << "bad criterion: " << criterion << " (expected <S10, z>)\n";
+        return 1;
+    }
+
+    double ms = 0;
+    MappedTrace mt;
+    string err;
+    std::set<int> ids;
+    int eid = -1, visited = 0;
+    string ctx_name;
+    try {
+        ScopedTimer timer(ms);
+        if (!mt.open(path, err)) { std::cerr << err << "\n"; return 1; }
+        int vid = mt.name_id(var);
+        eid = (vid < 0) ? -1 : mt.last_event_using(stmt_id, vid);
+        if (eid >= 0) {
+            ids = mt.thin_slice_from_event(eid, &visited);
+            ctx_name = mt.context_of(eid);
+        }
+    } catch (const std::runtime_error& ex) {
+        std::cerr << ex.what() << " (" << path << ")\n";
+        return 1;
+    }
+    if (eid < 0) {
+        std::cerr << "no event of S" << stmt_id << " reads or writes " << var << " (touched "
+                  << mt.pages_touched() << " of " << mt.pages_total() << " pages)\n";
+        return 1;
+    }
+
+    std::cout << "criterion event: E" << eid << " S" << stmt_id << " " << ctx_name << "\n";
+    std::cout << "=== THIN DYNAMIC SLICE (offline) for criterion <S" << stmt_id << ", " << var << "> ===\n";
+    print_slice(ids);
+    std::cout << "visited " << visited << " of " << mt.size() << " events, touched "
+              << mt.pages_touched() << " of " << mt.pages_total() << " pages\n";
+
+    rep.add("trace_file", "events", mt.size());
+    rep.add("trace_file", "file_bytes", (double)mt.file_bytes());
+    rep.add("trace_file", "slice_visits", visited);
+    rep.add("trace_file", "pages_touched", (double)mt.pages_touched());
+    rep.add("trace_file", "pages_total", (double)mt.pages_total());
+    rep.add("trace_file", "slice_ms", ms);
+    return 0;
+}
+
+// -------------------- Part (6): Value-delta trace compression --------------------
+//
+// Loop iterations produce events of the same *shape* (stmt + variables read and
+// written + number of memory accesses) whose values move by a constant. Each
+// event is flattened to a vector of integer fields and encoded against the
+// previous event of its shape:
+//
+//   FULL   : first event of a shape, absolute fields
+//   DELTA  : field deltas; they become the shape's stride
+//   STRIDE : fields = previous + stride (no payload)
+//   ALT    : fields = previous + the delta before the stride; the two swap
+//            (no payload; covers defs that alternate, e.g. p written every other iteration)
+//   RUN    : L, k -- the payload-free tokens of the last L events repeat k more times
+//
+// Numbers are zigzag LEB128 varints. Decoding is exact (see expand()).
+namespace tracezip {
+
+enum Kind : uint8_t { FULL = 0, DELTA = 1, STRIDE = 2, ALT = 3, RUN = 4 };
+const int MAX_PERIOD = 16; // longest loop body (in events) RUN looks for
+
+struct Shape {
+    int stmt = -1;
+    std::vector<uint32_t> read_vars, write_vars;
+    uint32_t n_mreads = 0, n_mwrites = 0;
+    bool operator<(const Shape& o) const {
+        return std::tie(stmt, read_vars, write_vars, n_mreads, n_mwrites)
+             < std::tie(o.stmt, o.read_vars, o.write_vars, o.n_mreads, o.n_mwrites);
+    }
+};
+
+static void put_varint(std::vector<uint8_t>& out, int64_t v) {
+    uint64_t z = ((uint64_t)v << 1) ^ (uint64_t)(v >> 63); // zigzag
+    while (z >= 0x80) { out.push_back((uint8_t)(z | 0x80)); z >>= 7; }
+    out.push_back((uint8_t)z);
+}
+
+static int64_t get_varint(const std::vector<uint8_t>& in, size_t& pos) {
+    uint64_t z = 0;
+    for (int shift = 0;; shift += 7) {
+        if (pos >= in.size()) throw std::runtime_error("truncated compressed trace");
+        uint8_t b = in[pos++];
+        // at most 10 bytes, and the 10th only carries bit 63
+        if (shift > 63 || (shift == 63 && (b & 0x7e))) throw std::runtime_error("corrupt compressed trace");
+        z |= (uint64_t)(b & 0x7f) << shift;
+        if (!(b & 0x80)) break;
+    }
+    return (int64_t)(z >> 1) ^ -(int64_t)(z & 1);
+}
+
+// non-negative count/id that must stay below `limit`
+static uint64_t get_count(const std::vector<uint8_t>& in, size_t& pos, uint64_t limit) {
+    int64_t v = get_varint(in, pos);
+    if (v < 0 || (uint64_t)v >= limit) throw std::runtime_error("corrupt compressed trace");
+    return (uint64_t)v;
+}
+
+// byte length of a block that follows in the buffer
+static size_t get_len(const std::vector<uint8_t>& in, size_t& pos) {
+    int64_t v = get_varint(in, pos);
+    if (v < 0 || (uint64_t)v > in.size() - pos) throw std::runtime_error("truncated compressed trace");
+    return (size_t)v;
+}
+
+// string table, front-coded: {count} then {prefix shared with previous entry, suffix length, suffix}
+static void put_strings(std::vector<uint8_t>& out, const std::vector<string>& tab) {
+    put_varint(out, (int64_t)tab.size());
+    const string* prev = nullptr;
+    for (auto& s : tab) {
+        size_t lcp = 0;
+        if (prev)
+            while (lcp < s.size() && lcp < prev->size() && s[lcp] == (*prev)[lcp]) ++lcp;
+        put_varint(out, (int64_t)lcp);
+        put_varint(out, (int64_t)(s.size() - lcp));
+        out.insert(out.end(), s.begin() + lcp, s.end());
+        prev = &s;
+    }
+}
+
+static std::vector<string> get_strings(const std::vector<uint8_t>& in, size_t& pos) {
+    std::vector<string> tab(get_count(in, pos, in.size() + 1));
+    for (size_t k = 0; k < tab.size(); ++k) {
+        size_t lcp = get_count(in, pos, k ? tab[k - 1].size() + 1 : 1);
+        size_t len = get_len(in, pos);
+        tab[k] = (k ? tab[k - 1].substr(0, lcp) : string());
+        tab[k].append(in.begin() + pos, in.begin() + pos + len);
+        pos += len;
+    }
+    return tab;
+}
+
+} // namespace tracezip
+
+struct CompressedTrace {
+    std::vector<string> names, ctxs;
+    std::vector<tracezip::Shape> shapes;
+    std::vector<uint8_t> stream;
+    uint64_t n_events = 0;
+    uint64_t n_full = 0, n_delta = 0, n_stride = 0, n_alt = 0, n_runs = 0, run_events = 0;
+
+    // "HW3ZIP01", then varints: n_events, names, contexts (front-coded),
+    // shapes {stmt, #reads, name ids, #writes, name ids, #mem_reads, #mem_writes},
+    // stream length + stream bytes. Token counters are not stored.
+    std::vector<uint8_t> serialize() const;
+    // Throws std::runtime_error on a malformed buffer.
+    static CompressedTrace deserialize(const std::vector<uint8_t>& in);
+
+    // Exact inverse of TraceCompressor; throws std::runtime_error on a corrupt stream.
+    std::vector<TraceEvent> expand() const;
+};
+
+static const char ZIP_MAGIC[8] = {'H', 'W', '3', 'Z', 'I', 'P', '0', '1'};
+
+std::vector<uint8_t> CompressedTrace::serialize() const {
+    using namespace tracezip;
+    std::vector<uint8_t> out(ZIP_MAGIC, ZIP_MAGIC + sizeof(ZIP_MAGIC));
+    put_varint(out, (int64_t)n_events);
+    put_strings(out, names);
+    put_strings(out, ctxs);
+    put_varint(out, (int64_t)shapes.size());
+    for (auto& sh : shapes) {
+        put_varint(out, sh.stmt);
+        put_varint(out, (int64_t)sh.read_vars.size());
+        for (uint32_t v : sh.read_vars) put_varint(out, v);
+        put_varint(out, (int64_t)sh.write_vars.size());
+        for (uint32_t v : sh.write_vars) put_varint(out, v);
+        put_varint(out, sh.n_mreads);
+        put_varint(out, sh.n_mwrites);
+    }
+    put_varint(out, (int64_t)stream.size());
+    out.insert(out.end(), stream.begin(), stream.end());
+    return out;
+}
+
+CompressedTrace CompressedTrace::deserialize(const std::vector<uint8_t>& in) {
+    using namespace tracezip;
+    if (in.size() < sizeof(ZIP_MAGIC) || !std::equal(ZIP_MAGIC, ZIP_MAGIC + sizeof(ZIP_MAGIC), in.begin()))
+        throw std::runtime_error("not a compressed trace");
+    CompressedTrace ct;
+    size_t pos = sizeof(ZIP_MAGIC);
+    ct.n_events = (uint64_t)get_varint(in, pos);
+    ct.names = get_strings(in, pos);
+    ct.ctxs = get_strings(in, pos);
+    ct.shapes.resize(get_count(in, pos, in.size() + 1));
+    auto ids = [&](std::vector<uint32_t>& v) {
+        v.resize(get_count(in, pos, in.size() + 1));
+        for (auto& x : v) x = (uint32_t)get_count(in, pos, ct.names.size());
+    };
+    for (auto& sh : ct.shapes) {
+        sh.stmt = (int)get_varint(in, pos);
+        ids(sh.read_vars);
+        ids(sh.write_vars);
+        sh.n_mreads = (uint32_t)get_count(in, pos, in.size() + 1);
+        sh.n_mwrites = (uint32_t)get_count(in, pos, in.size() + 1);
+    }
+    size_t len = get_len(in, pos);
+    ct.stream.assign(in.begin() + pos, in.begin() + pos + len);
+    return ct;
+}
+
+// layout of a shape's field vector
+static size_t shape_fields(const tracezip::Shape& s) {
+    return 1 + 2 * s.read_vars.size() + s.write_vars.size() + 3 * s.n_mreads + 2 * s.n_mwrites;
+}
+
+class TraceCompressor {
+    struct ShapeState {
+        std::vector<int64_t> last, stride, prev_stride;
+    };
+    struct Token {
+        tracezip::Kind kind;
+        uint32_t shape;
+        uint32_t payload_off, payload_len; // into payload
+    };
+
+    CompressedTrace out;
+    std::map<tracezip::Shape, uint32_t> shape_ids;
+    std::unordered_map<string, uint32_t> name_ids, ctx_ids;
+    std::vector<ShapeState> state;
+    std::vector<Token> tokens;
+    std::vector<uint8_t> payload;
+
+    static uint32_t intern(std::unordered_map<string, uint32_t>& ids, std::vector<string>& tab, const string& s) {
+        auto it = ids.find(s);
+        if (it != ids.end()) return it->second;
+        ids.emplace(s, (uint32_t)tab.size());
+        tab.push_back(s);
+        return (uint32_t)tab.size() - 1;
+    }
+
+public:
+    void add(const TraceEvent& e) {
+        using namespace tracezip;
+        Shape sh;
+        sh.stmt = e.stmt;
+        std::vector<int64_t> f;
+        f.push_back(intern(ctx_ids, out.ctxs, e.idx));
+        for (auto& [v, val] : e.reads) {
+            auto it = e.use_def_var.find(v);
+            sh.read_vars.push_back(intern(name_ids, out.names, v));
+            f.push_back(val);
+            f.push_back(it == e.use_def_var.end() ? -1 : it->second);
+        }
+        for (auto& [v, val] : e.writes) {
+            sh.write_vars.push_back(intern(name_ids, out.names, v));
+            f.push_back(val);
+        }
+        for (auto& [a, val] : e.mem_reads) {
+            auto it = e.use_def_mem.find(a);
+            f.push_back((int64_t)a);
+            f.push_back(val);
+            f.push_back(it == e.use_def_mem.end() ? -1 : it->second);
+        }
+        for (auto& [a, val] : e.mem_writes) {
+            f.push_back((int64_t)a);
+            f.push_back(val);
+        }
+        sh.n_mreads = (uint32_t)e.mem_reads.size();
+        sh.n_mwrites = (uint32_t)e.mem_writes.size();
+
+        auto it = shape_ids.find(sh);
+        uint32_t sid;
+        if (it == shape_ids.end()) {
+            sid = (uint32_t)out.shapes.size();
+            shape_ids.emplace(sh, sid);
+            out.shapes.push_back(std::move(sh));
+            state.emplace_back();
+        } else {
+            sid = it->second;
+        }
+
+        ShapeState& st = state[sid];
+        Token t{FULL, sid, (uint32_t)payload.size(), 0};
+        if (st.last.empty()) {
+            for (int64_t x : f) put_varint(payload, x);
+        } else {
+            std::vector<int64_t> d(f.size());
+            for (size_t k = 0; k < f.size(); ++k) d[k] = (int64_t)((uint64_t)f[k] - (uint64_t)st.last[k]);
+            if (d == st.stride) {
+                t.kind = STRIDE;
+            } else if (d == st.prev_stride) {
+                t.kind = ALT;
+                st.stride.swap(st.prev_stride);
+            } else {
+                t.kind = DELTA;
+                for (int64_t x : d) put_varint(payload, x);
+                st.prev_stride = std::move(st.stride);
+                st.stride = std::move(d);
+            }
+        }
+        t.payload_len = (uint32_t)payload.size() - t.payload_off;
+        st.last = std::move(f);
+        tokens.push_back(t);
+        ++out.n_events;
+    }
+
+    // RLE pass: replace periodic stretches of STRIDE/ALT tokens by RUN(L, k).
+    CompressedTrace finish() {
+        using namespace tracezip;
+        size_t n = tokens.size(), i = 0;
+        while (i < n) {
+            size_t best_len = 0, best_L = 0;
+            for (size_t L = 1; L <= (size_t)MAX_PERIOD && L <= i; ++L) {
+                size_t j = i;
+                while (j < n && (tokens[j].kind == STRIDE || tokens[j].kind == ALT)
+                       && tokens[j].kind == tokens[j - L].kind && tokens[j].shape == tokens[j - L].shape) ++j;
+                size_t covered = (j - i) / L * L;
+                if (covered > best_len) { best_len = covered; best_L = L; }
+            }
+            if (best_len >= 2) {
+                out.stream.push_back(RUN);
+                put_varint(out.stream, (int64_t)best_L);
+                put_varint(out.stream, (int64_t)(best_len / best_L));
+                ++out.n_runs;
+                out.run_events += best_len;
+                i += best_len;
+                continue;
+            }
+            const Token& t = tokens[i++];
+            out.stream.push_back(t.kind);
+            put_varint(out.stream, t.shape);
+            out.stream.insert(out.stream.end(), payload.begin() + t.payload_off,
+                              payload.begin() + t.payload_off + t.payload_len);
+            if (t.kind == FULL) ++out.n_full;
+            else if (t.kind == DELTA) ++out.n_delta;
+            else if (t.kind == ALT) ++out.n_alt;
+            else ++out.n_stride;
+        }
+        tokens.clear();
+        payload.clear();
+        return std::move(out);
+    }
+};
+
+std::vector<TraceEvent> CompressedTrace::expand() const {
+    using namespace tracezip;
+    std::vector<TraceEvent> evs;
+    evs.reserve((size_t)std::min<uint64_t>(n_events, 1u << 24));
+    std::vector<std::vector<int64_t>> last(shapes.size()), stride(shapes.size()), prev_stride(shapes.size());
+    std::vector<std::pair<Kind, uint32_t>> token_of; // per decoded event, for RUN replay
+    token_of.reserve((size_t)std::min<uint64_t>(n_events, 1u << 24));
+
+    auto emit = [&](uint32_t sid) {
+        const Shape& sh = shapes[sid];
+        const auto& f = last[sid];
+        if (evs.size() >= n_events) throw std::runtime_error("corrupt compressed trace");
+        TraceEvent e;
+        e.eid = (int)evs.size();
+        e.stmt = sh.stmt;
+        size_t k = 0;
+        if (f[0] < 0 || (uint64_t)f[0] >= ctxs.size()) throw std::runtime_error("corrupt compressed trace");
+        e.idx = ctxs[(size_t)f[k++]];
+        for (uint32_t v : sh.read_vars) {
+            e.reads.push_back({names[v], f[k]});
+            e.use_def_var[names[v]] = (int)f[k + 1];
+            k += 2;
+        }
+        for (uint32_t v : sh.write_vars) e.writes.push_back({names[v], f[k++]});
+        for (uint32_t m = 0; m < sh.n_mreads; ++m, k += 3) {
+            e.mem_reads.push_back({(uint64_t)f[k], f[k + 1]});
+            e.use_def_mem[(uint64_t)f[k]] = (int)f[k + 2];
+        }
+        for (uint32_t m = 0; m < sh.n_mwrites; ++m, k += 2) e.mem_writes.push_back({(uint64_t)f[k], f[k + 1]});
+        evs.push_back(std::move(e));
+    };
+    // a payload-free token needs a full field vector and the stride(s) it applies
+    auto check_step = [&](Kind kind, uint32_t sid) {
+        size_t nf = shape_fields(shapes[sid]);
+        bool ok = (kind == STRIDE || kind == ALT) && last[sid].size() == nf && stride[sid].size() == nf
+               && (kind == STRIDE || prev_stride[sid].size() == nf);
+        if (!ok) throw std::runtime_error("corrupt compressed trace");
+    };
+    auto step = [&](Kind kind, uint32_t sid) {
+        if (kind == ALT) stride[sid].swap(prev_stride[sid]);
+        token_of.push_back({kind, sid});
+        for (size_t k = 0; k < last[sid].size(); ++k)
+            last[sid][k] = (int64_t)((uint64_t)last[sid][k] + (uint64_t)stride[sid][k]);
+        emit(sid);
+    };
+
+    size_t pos = 0;
+    while (pos < stream.size()) {
+        Kind kind = (Kind)stream[pos++];
+        if (kind == RUN) {
+            size_t L = get_count(stream, pos, token_of.size() + 1), reps = get_count(stream, pos, n_events + 1);
+            if (L == 0) throw std::runtime_error("corrupt compressed trace");
+            for (size_t r = 0; r < reps; ++r)
+                for (size_t k = 0; k < L; ++k) {
+                    auto [rk, rs] = token_of[token_of.size() - L];
+                    check_step(rk, rs);
+                    step(rk, rs);
+                }
+            continue;
+        }
+        uint32_t sid = (uint32_t)get_count(stream, pos, shapes.size());
+        size_t nf = shape_fields(shapes[sid]);
+        if (kind == FULL) {
+            last[sid].resize(nf);
+            for (auto& x : last[sid]) x = get_varint(stream, pos);
+            token_of.push_back({FULL, sid});
+            emit(sid);
+        } else if (kind == DELTA) {
+            if (last[sid].size() != nf) throw std::runtime_error("corrupt compressed trace");
+            prev_stride[sid] = std::move(stride[sid]);
+            stride[sid].resize(nf);
+            for (auto& x : stride[sid]) x = get_varint(stream, pos);
+            step(DELTA, sid);
+        } else {
+            check_step(kind, sid);
+            step(kind, sid);
+        }
+    }
+    if (evs.size() != n_events) throw std::runtime_error("corrupt compressed trace");
+    return evs;
+}
+
+static bool same_event(const TraceEvent& a, const TraceEvent& b) {
+    return a.eid == b.eid && a.stmt == b.stmt && a.idx == b.idx && a.reads == b.reads
+        && a.writes == b.writes && a.mem_reads == b.mem_reads && a.mem_writes == b.mem_writes
+        && a.use_def_var == b.use_def_var && a.use_def_mem == b.use_def_mem;
+}
+
+static int demo_trace_bench(int input, StatsReport& rep) {
+    ExecContext ctx;
+    Tracer tr(&ctx);
+    tr.checkpoint_every = 0;
+    double trace_ms = 0, zip_ms = 0, unzip_ms = 0;
+    {
+        ScopedTimer timer(trace_ms);
+        run_slice_program(ctx, tr, input);
+    }
+
+    // timings include (de)serialization: the size reported is the buffer's
+    CompressedTrace ct;
+    std::vector<uint8_t> blob;
+    {
+        ScopedTimer timer(zip_ms);
+        TraceCompressor zip;
+        for (auto& e : tr.evs) zip.add(e);
+        ct = zip.finish();
+        blob = ct.serialize();
+    }
+    std::vector<TraceEvent> back;
+    {
+        ScopedTimer timer(unzip_ms);
+        back = CompressedTrace::deserialize(blob).expand();
+    }
+    double zbytes = (double)blob.size();
+    bool lossless = (back.size() == tr.evs.size());
+    for (size_t k = 0; lossless && k < back.size(); ++k) lossless = same_event(back[k], tr.evs[k]);
+
+    using namespace tracefile;
+    size_t mem_bytes = 0, flat_bytes = 0;
+    for (auto& e : tr.evs) {
+        mem_bytes += approx_event_bytes(e);
+        flat_bytes += REC_HDR_SZ + e.reads.size() * READ_SZ + e.writes.size() * WRITE_SZ
+                    + e.mem_reads.size() * MREAD_SZ + e.mem_writes.size() * MWRITE_SZ;
+    }
+    double n = (double)tr.evs.size();
+    auto per_sec = [&](double ms) { return ms > 0 ? n * 1000.0 / ms : 0.0; };
+
+    std::cout << "=== TRACE COMPRESSION (trace_slice " << input << ") ===\n";
+    std::cout << "events=" << tr.evs.size() << " shapes=" << ct.shapes.size() << "\n";
+    std::cout << "tokens: full=" << ct.n_full << " delta=" << ct.n_delta << " stride=" << ct.n_stride
+              << " alt=" << ct.n_alt << " runs=" << ct.n_runs << " (covering " << ct.run_events << " events)\n";
+    std::cout << "in-memory trace ~" << mem_bytes << " B, flat records " << flat_bytes
+              << " B, serialized compressed " << blob.size() << " B\n";
+    std::cout << "ratio vs in-memory=" << mem_bytes / zbytes << "x, vs flat=" << flat_bytes / zbytes << "x\n";
+    std::cout << "trace " << per_sec(trace_ms) << " ev/s, compress " << per_sec(zip_ms)
+              << " ev/s, expand " << per_sec(unzip_ms) << " ev/s\n";
+    std::cout << "lossless: " << (lossless ? "yes" : "NO") << "\n";
+
+    tr.add_stats(rep, trace_ms);
+    rep.add("compress", "shapes", (double)ct.shapes.size());
+    rep.add("compress", "bytes", zbytes);
+    rep.add("compress", "ratio_vs_memory", mem_bytes / zbytes);
+    rep.add("compress", "ratio_vs_flat", flat_bytes / zbytes);
+    rep.add("compress", "compress_ms", zip_ms);
+    rep.add("compress", "expand_ms", unzip_ms);
+    return lossless ? 0 : 1;
 }
 
 int main(int argc, char** argv) {
-    if (argc < 2) {
+    // --stats[=text|json] can go anywhere on the command line; report -> stderr
+    string stats_fmt;
+    std::vector<string> args;
+    for (int k = 1; k < argc; ++k) {
+        string a = argv[k];
+        if (a == "--stats" || a == "--stats=text") stats_fmt = "text";
+        else if (a == "--stats=json") stats_fmt = "json";
+        else args.push_back(a);
+    }
+
+    const char* usage_save = "  ./hw3 trace_save <input> <file> [--stats[=json]]\n";
+    const char* usage_offline = "  ./hw3 slice_offline <file> \"<S10, z>\" [--stats[=json]]\n";
+    if (args.empty()) {
         std::cerr << "Usage:\n"
-                  << "  ./hw3 trace_slice <input>\n"
-                  << "  ./hw3 exec_index\n"
-                  << "  ./hw3 fault_loc\n";
+                  << "  ./hw3 trace_slice <input> [--stats[=json]]\n"
+                  << "  ./hw3 exec_index [<index> [<stmt>]] [--stats[=json]]\n"
+                  << "  ./hw3 fault_loc [--stats[=json]]\n"
+                  << usage_save
+                  << usage_offline
+                  << "  ./hw3 trace_bench <input> [--stats[=json]]\n";
         return 1;
     }
 
-    string mode = argv[1];
+    StatsReport rep;
+    rep.enabled = !stats_fmt.empty();
+    string mode = args[0];
     if (mode == "trace_slice") {
-        int input = (argc >= 3) ? std::stoi(argv[2]) : 1;
-        demo_trace_and_slice(input);
-        return 0;
-    }
-    if (mode == "exec_index") {
-        demo_execution_indexing();
-        return 0;
-    }
-    if (mode == "fault_loc") {
-        demo_fault_localization();
-        return 0;
+        int input = (args.size() >= 2) ? std::stoi(args[1]) : 1;
+        demo_trace_and_slice(input, rep);
+    } else if (mode == "exec_index") {
+        string idx = (args.size() >= 2) ? args[1] : "<main/LoopK#2/F/foo#2>";
+        int stmt = (args.size() >= 3) ? std::stoi(args[2]) : 101;
+        demo_execution_indexing(idx, stmt, rep);
+    } else if (mode == "fault_loc") {
+        demo_fault_localization(rep);
+    } else if (mode == "trace_bench") {
+        int input = (args.size() >= 2) ? std::stoi(args[1]) : 100000;
+        int rc = demo_trace_bench(input, rep);
+        if (rc != 0) return rc;
+    } else if (mode == "trace_save") {
+        if (args.size() < 3) { std::cerr << "Usage:\n" << usage_save; return 1; }
+        int rc = demo_trace_save(std::stoi(args[1]), args[2], rep);
+        if (rc != 0) return rc;
+    } else if (mode == "slice_offline") {
+        if (args.size() < 3) { std::cerr << "Usage:\n" << usage_offline; return 1; }
+        string crit;
+        for (size_t k = 2; k < args.size(); ++k) crit += (k > 2 ? " " : "") + args[k];
+        int rc = demo_slice_offline(args[1], crit, rep);
+        if (rc != 0) return rc;
+    } else {
+        std::cerr << "Unknown mode: " << mode << "\n";
+        return 1;
     }
 
-    std::cerr << "Unknown mode: " << mode << "\n";
-    return 1;
+    if (!stats_fmt.empty()) rep.print(std::cerr, stats_fmt == "json");
+    return 0;
 }
\ No newline at end of file